@@ -257,22 +257,6 @@ bool BsonParser::readBool()
                      "Failed to read Bool");
 }
 
-HEADER_ONLY_INCLUDE
-std::size_t BsonParser::peekSize()
-{
-    std::int32_t size;
-
-    std::streampos pos = input.tellg();
-    if (input.read(reinterpret_cast<char*>(&size), 4))
-    {
-        input.seekg(pos);
-        return boost::endian::little_to_native(size);
-    }
-    ThorsLogAndThrow("ThorsAnvil::Serialize::BsonParser",
-                     "peekSize",
-                     "Failed to peek at the size of the next object");
-}
-
 HEADER_ONLY_INCLUDE
 std::string BsonParser::readString()
 {
@@ -322,6 +306,21 @@ std::string BsonParser::getKey()
     return nextKey;
 }
 
+HEADER_ONLY_INCLUDE
+ParserInterface::ValueKind BsonParser::getValueKind()
+{
+    switch (nextType)
+    {
+        case '\x01':    return ValueKind::Float;
+        case '\x02':    return ValueKind::String;
+        case '\x08':    return ValueKind::Bool;
+        case '\x0A':    return ValueKind::Null;
+        case '\x10':    return ValueKind::Integer;
+        case '\x12':    return ValueKind::Integer;
+        default:        return ValueKind::Other;
+    }
+}
+
 HEADER_ONLY_INCLUDE
 std::string BsonParser::getRawValue()
 {
@@ -350,3 +349,67 @@ std::string BsonParser::getRawValue()
         }
     }
 }
+
+HEADER_ONLY_INCLUDE
+BsonStreamCounter::BsonStreamCounter(std::istream& stream)
+    : stream(stream)
+    , source(stream.rdbuf())
+    , count(0)
+{
+    // rdbuf() resets the stream state so preserve it.
+    std::ios_base::iostate state = stream.rdstate();
+    stream.rdbuf(this);
+    stream.setstate(state);
+}
+
+HEADER_ONLY_INCLUDE
+BsonStreamCounter::~BsonStreamCounter()
+{
+    std::ios_base::iostate state = stream.rdstate();
+    stream.rdbuf(source);
+    stream.setstate(state);
+}
+
+HEADER_ONLY_INCLUDE
+BsonStreamCounter::int_type BsonStreamCounter::underflow()
+{
+    return source->sgetc();
+}
+
+HEADER_ONLY_INCLUDE
+BsonStreamCounter::int_type BsonStreamCounter::uflow()
+{
+    int_type result = source->sbumpc();
+    if (!traits_type::eq_int_type(result, traits_type::eof()))
+    {
+        ++count;
+    }
+    return result;
+}
+
+HEADER_ONLY_INCLUDE
+BsonStreamCounter::int_type BsonStreamCounter::pbackfail(int_type c)
+{
+    int_type result = traits_type::eq_int_type(c, traits_type::eof())
+                        ? source->sungetc()
+                        : source->sputbackc(traits_type::to_char_type(c));
+    if (!traits_type::eq_int_type(result, traits_type::eof()))
+    {
+        --count;
+    }
+    return result;
+}
+
+HEADER_ONLY_INCLUDE
+std::streamsize BsonStreamCounter::showmanyc()
+{
+    return source->in_avail();
+}
+
+HEADER_ONLY_INCLUDE
+std::streamsize BsonStreamCounter::xsgetn(char_type* s, std::streamsize n)
+{
+    std::streamsize result = source->sgetn(s, n);
+    count += result;
+    return result;
+}
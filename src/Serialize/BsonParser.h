@@ -24,6 +24,7 @@
 #include <GitUtility/ieee754_types.h>
 #include <boost/endian/conversion.hpp>
 #include <istream>
+#include <streambuf>
 #include <string>
 #include <vector>
 
@@ -78,6 +79,7 @@ class BsonParser: public ParserInterface
         virtual void    getValue(std::string& value)            override    {if (nextType != '\x02')    {badType("String", nextType);}value = readString();}
 
         virtual bool    isValueNull()                           override    {return (nextType == '\x0A');}
+        virtual ValueKind getValueKind()                        override;
 
         virtual std::string getRawValue()                       override;
 
@@ -104,7 +106,6 @@ class BsonParser: public ParserInterface
         template<std::size_t size, typename Int>
         Int readSize();
         bool isEndOfContainer(std::size_t unread);
-        std::size_t peekSize();
 
         void readEndOfContainer();
 
@@ -163,6 +164,36 @@ class BsonParser: public ParserInterface
         }
 };
 
+/*
+ * BsonStreamCounter
+ *      Custom serializers (see CustomSerialization.h) read their data directly from
+ *      the stream. The parser needs to know how many bytes they consumed so it can
+ *      keep track of how much data is left in the current container.
+ *
+ *      Rather than use tellg() (which fails on pipes and sockets) this object
+ *      temporarily sits between the stream and its buffer and counts the bytes
+ *      that pass through it. The original buffer is restored on destruction.
+ */
+class BsonStreamCounter: public std::streambuf
+{
+    std::istream&       stream;
+    std::streambuf*     source;
+    std::size_t         count;
+    public:
+        BsonStreamCounter(std::istream& stream);
+        ~BsonStreamCounter();
+        BsonStreamCounter(BsonStreamCounter const&)             = delete;
+        BsonStreamCounter& operator=(BsonStreamCounter const&)  = delete;
+
+        std::size_t consumed() const {return count;}
+    protected:
+        virtual int_type        underflow()                             override;
+        virtual int_type        uflow()                                 override;
+        virtual int_type        pbackfail(int_type c)                   override;
+        virtual std::streamsize showmanyc()                             override;
+        virtual std::streamsize xsgetn(char_type* s, std::streamsize n) override;
+};
+
 template<std::size_t size, typename Int>
 inline Int BsonParser::readSize()
 {
@@ -15,6 +15,14 @@ BsonPrinter::BsonPrinter(std::ostream& output, PrinterConfig config)
     : PrinterInterface(output, config)
 {}
 
+HEADER_ONLY_INCLUDE
+void BsonPrinter::reset()
+{
+    currentKey.clear();
+    currentContainer.clear();
+    arrayIndex.clear();
+}
+
 // MAP
 HEADER_ONLY_INCLUDE
 std::size_t BsonPrinter::getSizeMap(std::size_t count)
@@ -172,11 +180,18 @@ void BsonPrinter::writeBool(bool value)
 }
 
 HEADER_ONLY_INCLUDE
-void BsonPrinter::writeString(std::string const& value)
+void BsonPrinter::writeString(std::string const& value, bool stable)
 {
     writeKey('\x02', 4 + value.size() + 1);
     writeSize<4, std::int32_t>(value.size() + 1);
-    output << EscapeString(value);
+    if (stable && referenceOutput != nullptr && !EscapeString::needsEscape(value))
+    {
+        writeStable(value.data(), value.size());
+    }
+    else
+    {
+        output << EscapeString(value);
+    }
     output.write("", 1);
 }
 
@@ -194,3 +209,78 @@ void BsonPrinter::writeBinary(std::string const& value)
     output.write("\x80", 1);
     output.write(value.c_str(), value.size());
 }
+
+HEADER_ONLY_INCLUDE
+BsonBackPatchPrinter::BsonBackPatchPrinter(std::ostream& output, PrinterConfig config)
+    : BsonBackPatchBuffer()
+    , BsonPrinter(bufferOutput, config)
+    , finalOutput(output)
+    , containerSeen(false)
+{}
+
+HEADER_ONLY_INCLUDE
+void BsonBackPatchPrinter::closeDoc()
+{
+    if (!containerSeen)
+    {
+        // A single value was written (see BsonPrinter::writeKey()).
+        config.parserInfo = static_cast<long>(BsonContainer::Value);
+    }
+    BsonPrinter::closeDoc();
+    flush();
+}
+
+HEADER_ONLY_INCLUDE
+void BsonBackPatchPrinter::openMap(std::size_t size)
+{
+    containerSeen = true;
+    BsonPrinter::openMap(size);
+    sizeOffset.emplace_back(buffer.size() - 4);
+}
+
+HEADER_ONLY_INCLUDE
+void BsonBackPatchPrinter::closeMap()
+{
+    BsonPrinter::closeMap();
+    patchSize();
+}
+
+HEADER_ONLY_INCLUDE
+void BsonBackPatchPrinter::openArray(std::size_t size)
+{
+    containerSeen = true;
+    BsonPrinter::openArray(size);
+    sizeOffset.emplace_back(buffer.size() - 4);
+}
+
+HEADER_ONLY_INCLUDE
+void BsonBackPatchPrinter::closeArray()
+{
+    BsonPrinter::closeArray();
+    patchSize();
+}
+
+HEADER_ONLY_INCLUDE
+void BsonBackPatchPrinter::patchSize()
+{
+    std::size_t     offset  = sizeOffset.back();
+    std::int32_t    size    = boost::endian::native_to_little(static_cast<std::int32_t>(buffer.size() - offset));
+    buffer.replace(offset, 4, reinterpret_cast<char const*>(&size), 4);
+    sizeOffset.pop_back();
+    if (sizeOffset.empty())
+    {
+        flush();
+    }
+}
+
+HEADER_ONLY_INCLUDE
+void BsonBackPatchPrinter::flush()
+{
+    if (!finalOutput.write(buffer.data(), buffer.size()))
+    {
+        ThorsLogAndThrow("ThorsAnvil::Serialize::BsonBackPatchPrinter",
+                         "flush",
+                         "Failed to write to the output stream");
+    }
+    buffer.clear();
+}
@@ -66,10 +66,14 @@ class BsonPrinter: public PrinterInterface
         virtual void addValue(bool value)                           override    {writeBool(value);}
 
         virtual void addValue(std::string const& value)             override    {writeString(value);}
+        virtual void addStableValue(std::string const& value)       override    {writeString(value, true);}
 
         virtual void addRawValue(std::string const& value)          override    {writeBinary(value);}
 
         virtual void addNull()                                      override    {writeNull();}
+
+        // Prepare to write another document (see FixedBufferExporter.h).
+        void reset();
     protected:
         // Protected to allow unit tests
         virtual bool        printerUsesSize()                       override    {return true;}
@@ -114,12 +118,49 @@ class BsonPrinter: public PrinterInterface
         template<std::size_t size, typename Float>
         void writeFloat(Float value);
         void writeBool(bool value);
-        void writeString(std::string const& value);
+        void writeString(std::string const& value, bool stable = false);
         void writeNull();
         void writeBinary(std::string const& value);
 
 };
 
+/*
+ * BsonPrinter needs the size of each document when it is opened.
+ * When the size is not known up front (e.g. when transcoding from another format)
+ * use this printer: It writes each top level document into a buffer with a
+ * place holder for each size that is patched when the document is closed.
+ * The buffer is written to the output stream when the top level document is complete.
+ */
+struct BsonBackPatchBuffer
+{
+    std::string                 buffer;
+    StringOutputBuffer          bufferStream;
+    std::ostream                bufferOutput;
+
+    BsonBackPatchBuffer()
+        : bufferStream(buffer)
+        , bufferOutput(&bufferStream)
+    {}
+};
+
+class BsonBackPatchPrinter: private BsonBackPatchBuffer, public BsonPrinter
+{
+    std::ostream&               finalOutput;
+    std::vector<std::size_t>    sizeOffset;
+    bool                        containerSeen;
+    public:
+        BsonBackPatchPrinter(std::ostream& output, PrinterConfig config = PrinterConfig{});
+
+        virtual void closeDoc()                                     override;
+        virtual void openMap(std::size_t size)                      override;
+        virtual void closeMap()                                     override;
+        virtual void openArray(std::size_t size)                    override;
+        virtual void closeArray()                                   override;
+    private:
+        void patchSize();
+        void flush();
+};
+
 template<std::size_t size, typename Int>
 inline void BsonPrinter::writeSize(Int value)
 {
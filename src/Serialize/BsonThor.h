@@ -5,10 +5,12 @@
  *      ThorsAnvil::Serialize::Bson
  *      ThorsAnvil::Serialize::bsonExporter
  *      ThorsAnvil::Serialize::bsonImporter
+ *      ThorsAnvil::Serialize::bsonImportFile
  *
  * Usage:
  *      std::cout << bsonExporter(object); // converts object to Bson on an output stream
  *      std::cin  >> bsonImporter(object); // converts Bson to a C++ object from an input stream
+ *      bsonImportFile("file", object);    // converts the content of a (memory mapped) file to a C++ object
  */
 
 #include "BsonParser.h"
@@ -81,6 +83,7 @@ struct Bson
 // @param config.characteristics    'Default': uses Config/Stream depending on global config. 'Config':  Is verbose and logical. 'Stream':  Remove all white space.
 // @param config.polymorphicMarker  Jason object name for holding the polymorphic class name of the type. Default: __type
 // @param config.catchExceptions    'false:    exceptions propogate.   'true':   parsing exceptions are stopped.
+// @param config.polymorphicTypeId  'true':    the polymorphic type is written as an int32 id rather than the class name.
 // @return                          Object that can be passed to operator<< for serialization.
 template<typename T>
 Exporter<Bson, T> bsonExporter(T const& value, PrinterInterface::PrinterConfig config = PrinterInterface::PrinterConfig{})
@@ -96,6 +99,7 @@ Exporter<Bson, T> bsonExporter(T const& value, PrinterInterface::PrinterConfig c
 // @param config.parseStrictness    'Weak':    ignore missing extra fields. 'Strict': Any missing or extra fields throws exception.
 // @param config.polymorphicMarker  Jason object name for holding the polymorphic class name of the type. Default: __type
 // @param config.catchExceptions    'false:    exceptions propogate.        'true':   parsing exceptions are stopped.
+// @param config.polymorphicTypeId  'true':    the polymorphic type is read as an int32 id (must match the exporter).
 // @return                          Object that can be passed to operator>> for de-serialization.
 template<typename T>
 Importer<Bson, T> bsonImporter(T& value, ParserInterface::ParserConfig config = ParserInterface::ParserConfig{})
@@ -104,6 +108,19 @@ Importer<Bson, T> bsonImporter(T& value, ParserInterface::ParserConfig config =
 
     return Importer<Bson, T>(value, config);
 }
+// @function-api
+// @param path                      The file to read (it is memory mapped).
+// @param value                     The object to be de-serialized.
+// @param config                    See bsonImporter().
+// @param hugePages                 Hint that huge pages should be used for the mapping (for very large files).
+// @return                          true on success.
+template<typename T>
+bool bsonImportFile(std::string const& path, T& value, ParserInterface::ParserConfig config = ParserInterface::ParserConfig{}, bool hugePages = false)
+{
+    config.parserInfo = static_cast<long>(BsonBaseTypeGetter<T>::value);
+
+    return importFile<Bson>(path, value, config, hugePages);
+}
 
 // @function-api
 // @param value                     The object to be serialized.
@@ -0,0 +1,307 @@
+#include "SerializeConfig.h"
+#include "ChronoUtil.h"
+#include <istream>
+
+using namespace ThorsAnvil::Serialize::Chrono;
+
+namespace
+{
+    std::uint32_t const powersOfTen[] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000};
+
+    inline char* writeDigits(char* output, std::uint32_t value, int count)
+    {
+        for (int loop = count - 1; loop >= 0; --loop)
+        {
+            output[loop] = '0' + (value % 10);
+            value /= 10;
+        }
+        return output + count;
+    }
+    inline char* writeFraction(char* output, std::uint32_t nanos, int fractionDigits)
+    {
+        if (fractionDigits == 0)
+        {
+            return output;
+        }
+        *output++ = '.';
+        return writeDigits(output, nanos / powersOfTen[9 - fractionDigits], fractionDigits);
+    }
+
+    // Reads exactly "count" digits.
+    inline bool readDigits(char const*& begin, char const* end, int count, unsigned& value)
+    {
+        if (end - begin < count)
+        {
+            return false;
+        }
+        value = 0;
+        for (int loop = 0; loop < count; ++loop, ++begin)
+        {
+            if (*begin < '0' || *begin > '9')
+            {
+                return false;
+            }
+            value = value * 10 + (*begin - '0');
+        }
+        return true;
+    }
+    // Reads one or more digits.
+    inline bool readNumber(char const*& begin, char const* end, std::uint64_t& value)
+    {
+        char const* start = begin;
+        value = 0;
+        for (; begin != end && *begin >= '0' && *begin <= '9'; ++begin)
+        {
+            if (value > (UINT64_MAX - 9) / 10)
+            {
+                return false;
+            }
+            value = value * 10 + (*begin - '0');
+        }
+        return begin != start;
+    }
+    // Reads ".<digits>" (if present). Digits after the 9th are ignored.
+    inline bool readFraction(char const*& begin, char const* end, std::uint32_t& nanos)
+    {
+        nanos = 0;
+        if (begin == end || (*begin != '.' && *begin != ','))
+        {
+            return true;
+        }
+        ++begin;
+        int count = 0;
+        for (; begin != end && *begin >= '0' && *begin <= '9'; ++begin, ++count)
+        {
+            if (count < 9)
+            {
+                nanos = nanos * 10 + (*begin - '0');
+            }
+        }
+        if (count == 0)
+        {
+            return false;
+        }
+        if (count < 9)
+        {
+            nanos *= powersOfTen[9 - count];
+        }
+        return true;
+    }
+
+    inline unsigned daysInMonth(std::int64_t year, unsigned month)
+    {
+        static unsigned const days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+        bool leap = (year % 4 == 0) && ((year % 100 != 0) || (year % 400 == 0));
+        return (month == 2 && leap) ? 29 : days[month - 1];
+    }
+}
+
+HEADER_ONLY_INCLUDE
+std::size_t ThorsAnvil::Serialize::Chrono::formatISO8601Time(char* output, std::int64_t seconds, std::uint32_t nanos, int fractionDigits)
+{
+    std::int64_t    days            = seconds / 86400;
+    std::int64_t    secondOfDay     = seconds % 86400;
+    if (secondOfDay < 0)
+    {
+        secondOfDay += 86400;
+        --days;
+    }
+    std::int64_t    year;
+    unsigned        month;
+    unsigned        day;
+    civilFromDays(days, year, month, day);
+    if (year < 0 || year > 9999)
+    {
+        return 0;
+    }
+
+    std::uint32_t   sod  = static_cast<std::uint32_t>(secondOfDay);
+    char*           next = output;
+    next    = writeDigits(next, static_cast<std::uint32_t>(year), 4);
+    *next++ = '-';
+    next    = writeDigits(next, month, 2);
+    *next++ = '-';
+    next    = writeDigits(next, day, 2);
+    *next++ = 'T';
+    next    = writeDigits(next, sod / 3600, 2);
+    *next++ = ':';
+    next    = writeDigits(next, (sod / 60) % 60, 2);
+    *next++ = ':';
+    next    = writeDigits(next, sod % 60, 2);
+    next    = writeFraction(next, nanos, fractionDigits);
+    *next++ = 'Z';
+    return next - output;
+}
+
+HEADER_ONLY_INCLUDE
+bool ThorsAnvil::Serialize::Chrono::parseISO8601Time(char const* begin, char const* end, std::int64_t& seconds, std::uint32_t& nanos)
+{
+    unsigned year, month, day, hour, minute, second;
+    if (!readDigits(begin, end, 4, year)    || begin == end || *begin++ != '-'
+     || !readDigits(begin, end, 2, month)   || begin == end || *begin++ != '-'
+     || !readDigits(begin, end, 2, day)     || begin == end || (*begin != 'T' && *begin != 't' && *begin != ' ')
+     || !readDigits(++begin, end, 2, hour)  || begin == end || *begin++ != ':'
+     || !readDigits(begin, end, 2, minute)  || begin == end || *begin++ != ':'
+     || !readDigits(begin, end, 2, second)
+     || !readFraction(begin, end, nanos)
+     || begin == end)
+    {
+        return false;
+    }
+    // Second 60 is a leap second (it rolls over into the next minute).
+    if (month < 1 || month > 12 || day < 1 || day > daysInMonth(year, month) || hour > 23 || minute > 59 || second > 60)
+    {
+        return false;
+    }
+
+    std::int64_t offset = 0;
+    switch (*begin++)
+    {
+        case 'Z':
+        case 'z':
+            break;
+        case '+':
+        case '-':
+        {
+            unsigned offsetHour, offsetMinute;
+            if (!readDigits(begin, end, 2, offsetHour) || begin == end || *begin++ != ':' || !readDigits(begin, end, 2, offsetMinute)
+             || offsetHour > 23 || offsetMinute > 59)
+            {
+                return false;
+            }
+            offset = static_cast<std::int64_t>(offsetHour * 3600 + offsetMinute * 60) * (begin[-6] == '-' ? -1 : 1);
+            break;
+        }
+        default:
+            return false;
+    }
+    if (begin != end)
+    {
+        return false;
+    }
+    seconds = daysFromCivil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second - offset;
+    return true;
+}
+
+HEADER_ONLY_INCLUDE
+std::size_t ThorsAnvil::Serialize::Chrono::formatISO8601Duration(char* output, bool negative, std::uint64_t seconds, std::uint32_t nanos, int fractionDigits)
+{
+    char*   next = output;
+    if (negative)
+    {
+        *next++ = '-';
+    }
+    *next++ = 'P';
+    *next++ = 'T';
+
+    char    digits[20];
+    char*   digit = digits + sizeof(digits);
+    do
+    {
+        *--digit = '0' + (seconds % 10);
+        seconds /= 10;
+    }
+    while (seconds != 0);
+    while (digit != digits + sizeof(digits))
+    {
+        *next++ = *digit++;
+    }
+    if (nanos != 0)
+    {
+        next    = writeFraction(next, nanos, fractionDigits);
+        // Trailing zeros in the fraction carry no information.
+        while (next[-1] == '0')
+        {
+            --next;
+        }
+        if (next[-1] == '.')
+        {
+            --next;
+        }
+    }
+    *next++ = 'S';
+    return next - output;
+}
+
+HEADER_ONLY_INCLUDE
+bool ThorsAnvil::Serialize::Chrono::parseISO8601Duration(char const* begin, char const* end, bool& negative, std::uint64_t& seconds, std::uint32_t& nanos)
+{
+    negative    = false;
+    seconds     = 0;
+    nanos       = 0;
+    if (begin != end && (*begin == '-' || *begin == '+'))
+    {
+        negative = *begin++ == '-';
+    }
+    if (begin == end || *begin++ != 'P' || begin == end)
+    {
+        return false;
+    }
+
+    bool            timePart    = false;
+    char            lastUnit    = 'P';
+    while (begin != end)
+    {
+        if (*begin == 'T')
+        {
+            if (timePart)
+            {
+                return false;
+            }
+            timePart = true;
+            lastUnit = 'T';
+            if (++begin == end)
+            {
+                return false;
+            }
+            continue;
+        }
+
+        std::uint64_t   value;
+        std::uint32_t   fraction;
+        if (!readNumber(begin, end, value) || !readFraction(begin, end, fraction) || begin == end)
+        {
+            return false;
+        }
+        std::uint64_t   scale;
+        char            unit = *begin++;
+        // Units must appear in order: D before T; H, M, S after T.
+        if (!timePart && unit == 'D' && lastUnit == 'P')                        {scale = 86400;}
+        else if (timePart && unit == 'H' && lastUnit == 'T')                    {scale = 3600;}
+        else if (timePart && unit == 'M' && (lastUnit == 'T' || lastUnit == 'H')) {scale = 60;}
+        else if (timePart && unit == 'S' && lastUnit != 'S')                    {scale = 1;}
+        else
+        {
+            return false;
+        }
+        // Only the smallest unit may have a fraction.
+        if (fraction != 0 && (unit != 'S' || begin != end))
+        {
+            return false;
+        }
+        lastUnit = unit;
+        seconds += value * scale;
+        nanos    = fraction;
+    }
+    return lastUnit != 'T';
+}
+
+HEADER_ONLY_INCLUDE
+std::size_t ThorsAnvil::Serialize::Chrono::readJsonQuotedValue(std::istream& stream, char* buffer, std::size_t size)
+{
+    char    next;
+    if (!(stream >> next) || next != '"')
+    {
+        return 0;
+    }
+    std::size_t count = 0;
+    while (stream.get(next) && next != '"')
+    {
+        if (count == size)
+        {
+            return 0;
+        }
+        buffer[count++] = next;
+    }
+    return stream ? count : 0;
+}
@@ -0,0 +1,314 @@
+#ifndef THORS_ANVIL_SERIALIZE_CHRONO_UTIL_H
+#define THORS_ANVIL_SERIALIZE_CHRONO_UTIL_H
+/*
+ * Serialization of std::chrono types.
+ *
+ *      Traits<std::chrono::time_point<std::chrono::system_clock, Duration>>
+ *          Json/Yaml:  RFC-3339 / ISO-8601 string in UTC         "2023-04-05T06:07:08.123Z"
+ *                      The number of fractional digits depends on the precision of Duration.
+ *                      When reading any number of fractional digits and a "Z" or "+HH:MM"
+ *                      offset is accepted.
+ *          Bson:       '\x09' UTC datetime (milliseconds since the epoch).
+ *
+ *      Traits<std::chrono::duration<Rep, Period>>
+ *          Json/Yaml:  ISO-8601 duration string                  "PT90.5S"  or  "-PT3S"
+ *                      When reading days, hours and minutes are also accepted: "P1DT2H3M4.5S"
+ *          Bson:       '\x12' int64 count of Period units.
+ *
+ * The formatting and parsing functions below do not allocate and do not use
+ * strftime()/gmtime()/timegm() (they use the days_from_civil algorithm by Howard Hinnant).
+ */
+
+#include "Traits.h"
+#include "CustomSerialization.h"
+#include "ThorsLogging/ThorsLogging.h"
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+namespace ThorsAnvil
+{
+    namespace Serialize
+    {
+        namespace Chrono
+        {
+
+// "YYYY-MM-DDTHH:MM:SS.nnnnnnnnnZ"
+static constexpr std::size_t iso8601TimeMaxSize       = 30;
+// "-P" + "T" + 20 digit seconds + ".nnnnnnnnn" + "S"
+static constexpr std::size_t iso8601DurationMaxSize   = 34;
+
+// Days since 1970-01-01 of the civil date y-m-d (proleptic Gregorian calendar).
+constexpr std::int64_t daysFromCivil(std::int64_t y, unsigned m, unsigned d)
+{
+    y -= m <= 2;
+    std::int64_t const  era = (y >= 0 ? y : y - 399) / 400;
+    unsigned const      yoe = static_cast<unsigned>(y - era * 400);
+    unsigned const      doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+    unsigned const      doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<std::int64_t>(doe) - 719468;
+}
+
+// Inverse of daysFromCivil()
+constexpr void civilFromDays(std::int64_t z, std::int64_t& y, unsigned& m, unsigned& d)
+{
+    z += 719468;
+    std::int64_t const  era = (z >= 0 ? z : z - 146096) / 146097;
+    unsigned const      doe = static_cast<unsigned>(z - era * 146097);
+    unsigned const      yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    unsigned const      doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    unsigned const      mp  = (5 * doy + 2) / 153;
+    d = doy - (153 * mp + 2) / 5 + 1;
+    m = mp < 10 ? mp + 3 : mp - 9;
+    y = static_cast<std::int64_t>(yoe) + era * 400 + (m <= 2);
+}
+
+// Formats a point in time as "YYYY-MM-DDTHH:MM:SS[.f]Z" into output (which must hold iso8601TimeMaxSize chars).
+// "seconds" is the number of seconds since the epoch and "nanos" (0 <= nanos < 1e9) the sub second part.
+// "fractionDigits" must be 0, 3, 6 or 9. Returns the number of characters written (no terminating null).
+// Returns 0 if the year is outside the range 0000-9999 (which can not be represented).
+std::size_t formatISO8601Time(char* output, std::int64_t seconds, std::uint32_t nanos, int fractionDigits);
+// Parses a RFC-3339 time. Returns false if [begin, end) is not a valid time.
+bool        parseISO8601Time(char const* begin, char const* end, std::int64_t& seconds, std::uint32_t& nanos);
+
+// Formats a duration as "[-]PT<seconds>[.f]S".
+std::size_t formatISO8601Duration(char* output, bool negative, std::uint64_t seconds, std::uint32_t nanos, int fractionDigits);
+// Parses "[-]P[nD][T[nH][nM][n[.f]S]]". Returns false if [begin, end) is not a valid duration.
+bool        parseISO8601Duration(char const* begin, char const* end, bool& negative, std::uint64_t& seconds, std::uint32_t& nanos);
+
+// Reads a quoted string from a Json stream into buffer without allocating.
+// Returns the size of the string (or 0 if the value is not a string or is too long).
+std::size_t readJsonQuotedValue(std::istream& stream, char* buffer, std::size_t size);
+
+template<typename Period>
+constexpr int fractionDigitsFor()
+{
+    return Period::den == 1         ? 0
+         : Period::den <= 1000      ? 3
+         : Period::den <= 1000000   ? 6
+         :                            9;
+}
+
+template<typename Rep, typename Period>
+void splitDuration(std::chrono::duration<Rep, Period> const& value, std::int64_t& seconds, std::uint32_t& nanos)
+{
+    using namespace std::chrono;
+    auto    wholeSeconds = floor<std::chrono::seconds>(value);
+    seconds = wholeSeconds.count();
+    nanos   = static_cast<std::uint32_t>(duration_cast<nanoseconds>(value - wholeSeconds).count());
+}
+
+template<typename Duration>
+Duration joinDuration(std::int64_t seconds, std::uint32_t nanos)
+{
+    using namespace std::chrono;
+    return duration_cast<Duration>(std::chrono::seconds(seconds)) + duration_cast<Duration>(nanoseconds(nanos));
+}
+
+template<typename Duration>
+class TimePointSerializer: public DefaultCustomSerializer<std::chrono::time_point<std::chrono::system_clock, Duration>>
+{
+    using TimePoint = std::chrono::time_point<std::chrono::system_clock, Duration>;
+    static constexpr int fractionDigits = std::is_floating_point<typename Duration::rep>::value ? 9 : fractionDigitsFor<typename Duration::period>();
+
+    static std::size_t format(char* buffer, TimePoint const& object)
+    {
+        std::int64_t    seconds;
+        std::uint32_t   nanos;
+        splitDuration(object.time_since_epoch(), seconds, nanos);
+        std::size_t size = formatISO8601Time(buffer, seconds, nanos, fractionDigits);
+        if (size == 0)
+        {
+            ThorsLogAndThrow("ThorsAnvil::Serialize::Chrono::TimePointSerializer",
+                             "format",
+                             "Time point is outside the range that can be represented as ISO-8601");
+        }
+        return size;
+    }
+    static void parse(char const* begin, char const* end, TimePoint& object)
+    {
+        std::int64_t    seconds;
+        std::uint32_t   nanos;
+        if (!parseISO8601Time(begin, end, seconds, nanos))
+        {
+            ThorsLogAndThrow("ThorsAnvil::Serialize::Chrono::TimePointSerializer",
+                             "parse",
+                             "Invalid ISO-8601 time: ", std::string(begin, end));
+        }
+        object = TimePoint(joinDuration<Duration>(seconds, nanos));
+    }
+    public:
+        virtual char getBsonByteMark() const override                                                               {return '\x09';}
+        virtual std::size_t getPrintSizeBson(BsonPrinter& /*printer*/, TimePoint const& /*object*/) const override  {return 8;}
+        virtual void writeBson(BsonPrinter& printer, TimePoint const& object) const override
+        {
+            std::int64_t millis = std::chrono::floor<std::chrono::milliseconds>(object.time_since_epoch()).count();
+            printer.writeLE<8, std::int64_t>(millis);
+        }
+        virtual void readBson(BsonParser& parser, char /*byteMarker*/, TimePoint& object) const override
+        {
+            std::int64_t millis = parser.readLE<8, std::int64_t>();
+            object = TimePoint(std::chrono::duration_cast<Duration>(std::chrono::milliseconds(millis)));
+        }
+        virtual void writeJson(JsonPrinter& printer, TimePoint const& object) const override
+        {
+            char        buffer[iso8601TimeMaxSize + 2];
+            buffer[0]   = '"';
+            std::size_t size = format(buffer + 1, object);
+            buffer[size + 1] = '"';
+            printer.stream().write(buffer, size + 2);
+        }
+        virtual void readJson(JsonParser& parser, TimePoint& object) const override
+        {
+            // Allow for a generous number of fractional digits.
+            char        buffer[64];
+            std::size_t size = readJsonQuotedValue(parser.stream(), buffer, sizeof(buffer));
+            parse(buffer, buffer + size, object);
+        }
+        virtual void writeYaml(YamlPrinter& printer, TimePoint const& object) const override
+        {
+            char        buffer[iso8601TimeMaxSize];
+            std::size_t size = format(buffer, object);
+            printer.addValue(std::string(buffer, size));
+        }
+        virtual void readYaml(YamlParser& parser, TimePoint& object) const override
+        {
+            std::string value;
+            parser.getValue(value);
+            parse(value.data(), value.data() + value.size(), object);
+        }
+};
+
+template<typename Rep, typename Period>
+class DurationSerializer: public DefaultCustomSerializer<std::chrono::duration<Rep, Period>>
+{
+    using Duration = std::chrono::duration<Rep, Period>;
+    static constexpr int fractionDigits = std::is_floating_point<Rep>::value ? 9 : fractionDigitsFor<Period>();
+
+    static std::size_t format(char* buffer, Duration const& object)
+    {
+        bool            negative = object < Duration::zero();
+        std::int64_t    seconds;
+        std::uint32_t   nanos;
+        splitDuration(negative ? -object : object, seconds, nanos);
+        return formatISO8601Duration(buffer, negative, static_cast<std::uint64_t>(seconds), nanos, fractionDigits);
+    }
+    static void parse(char const* begin, char const* end, Duration& object)
+    {
+        bool            negative;
+        std::uint64_t   seconds;
+        std::uint32_t   nanos;
+        if (!parseISO8601Duration(begin, end, negative, seconds, nanos))
+        {
+            ThorsLogAndThrow("ThorsAnvil::Serialize::Chrono::DurationSerializer",
+                             "parse",
+                             "Invalid ISO-8601 duration: ", std::string(begin, end));
+        }
+        object = joinDuration<Duration>(static_cast<std::int64_t>(seconds), nanos);
+        if (negative)
+        {
+            object = -object;
+        }
+    }
+    public:
+        // Bson: The count of the duration. A double (0x01) if Rep is floating point (so 1.5s is not truncated)
+        //       otherwise a 64 bit integer (0x12). Either is accepted when reading.
+        virtual char getBsonByteMark() const override                                                               {return std::is_floating_point<Rep>::value ? '\x01' : '\x12';}
+        virtual std::size_t getPrintSizeBson(BsonPrinter& /*printer*/, Duration const& /*object*/) const override   {return 8;}
+        virtual void writeBson(BsonPrinter& printer, Duration const& object) const override
+        {
+            if constexpr (std::is_floating_point<Rep>::value)
+            {
+                double          count = static_cast<double>(object.count());
+                std::uint64_t   bits;
+                std::memcpy(&bits, &count, sizeof(bits));
+                printer.writeLE<8, std::uint64_t>(bits);
+            }
+            else
+            {
+                printer.writeLE<8, std::int64_t>(static_cast<std::int64_t>(object.count()));
+            }
+        }
+        virtual void readBson(BsonParser& parser, char byteMarker, Duration& object) const override
+        {
+            if (byteMarker == '\x01')
+            {
+                std::uint64_t   bits = parser.readLE<8, std::uint64_t>();
+                double          count;
+                std::memcpy(&count, &bits, sizeof(count));
+                object = Duration(static_cast<Rep>(std::is_floating_point<Rep>::value ? count : std::llround(count)));
+            }
+            else
+            {
+                object = Duration(static_cast<Rep>(parser.readLE<8, std::int64_t>()));
+            }
+        }
+        virtual void writeJson(JsonPrinter& printer, Duration const& object) const override
+        {
+            char        buffer[iso8601DurationMaxSize + 2];
+            buffer[0]   = '"';
+            std::size_t size = format(buffer + 1, object);
+            buffer[size + 1] = '"';
+            printer.stream().write(buffer, size + 2);
+        }
+        virtual void readJson(JsonParser& parser, Duration& object) const override
+        {
+            char        buffer[64];
+            std::size_t size = readJsonQuotedValue(parser.stream(), buffer, sizeof(buffer));
+            parse(buffer, buffer + size, object);
+        }
+        virtual void writeYaml(YamlPrinter& printer, Duration const& object) const override
+        {
+            char        buffer[iso8601DurationMaxSize];
+            std::size_t size = format(buffer, object);
+            printer.addValue(std::string(buffer, size));
+        }
+        virtual void readYaml(YamlParser& parser, Duration& object) const override
+        {
+            std::string value;
+            parser.getValue(value);
+            parse(value.data(), value.data() + value.size(), object);
+        }
+};
+
+        }
+
+template<typename Duration>
+class Traits<std::chrono::time_point<std::chrono::system_clock, Duration>>
+{
+    public:
+        using DataType          = std::chrono::time_point<std::chrono::system_clock, Duration>;
+        static constexpr TraitType type = TraitType::Custom_Serialize;
+        using SerializingType   = Chrono::TimePointSerializer<Duration>;
+        static std::size_t getPrintSize(PrinterInterface& printer, DataType const& object, bool)
+        {
+            SerializingType info;
+            return info.getPrintSizeBson(dynamic_cast<BsonPrinter&>(printer), object);
+        }
+};
+
+template<typename Rep, typename Period>
+class Traits<std::chrono::duration<Rep, Period>>
+{
+    public:
+        using DataType          = std::chrono::duration<Rep, Period>;
+        static constexpr TraitType type = TraitType::Custom_Serialize;
+        using SerializingType   = Chrono::DurationSerializer<Rep, Period>;
+        static std::size_t getPrintSize(PrinterInterface& printer, DataType const& object, bool)
+        {
+            SerializingType info;
+            return info.getPrintSizeBson(dynamic_cast<BsonPrinter&>(printer), object);
+        }
+};
+
+    }
+}
+
+#if defined(HEADER_ONLY) && HEADER_ONLY == 1
+#include "ChronoUtil.source"
+#endif
+
+#endif
@@ -49,10 +49,10 @@ void DefaultCustomSerializer<T>::readCustom(ParserInterface& parser, T& object)
         case FormatType::Yaml:  return readYaml(dynamic_cast<YamlParser&>(parser), object);
         case FormatType::Bson:
         {
-            BsonParser& bsonParser = dynamic_cast<BsonParser&>(parser);
-            std::streampos pos = parser.stream().tellg();
+            BsonParser&         bsonParser = dynamic_cast<BsonParser&>(parser);
+            BsonStreamCounter   counter(parser.stream());
             readBson(bsonParser, bsonParser.getValueType(), object);
-            bsonParser.useStreamData(parser.stream().tellg() - pos);
+            bsonParser.useStreamData(counter.consumed());
             break;
         }
         default:
@@ -7,6 +7,9 @@
 
 #include "Serialize.h"
 #include "ThorsLogging/ThorsLogging.h"
+#include <cstddef>
+#include <ostream>
+#include <string>
 
 namespace ThorsAnvil
 {
@@ -74,6 +77,41 @@ Exporter<Format, T> Export(T const& value, PrinterInterface::PrinterConfig confi
     return Exporter<Format, T>(value, config);
 }
 
+// The exact number of bytes that Exporter<Format, T>(value, config) writes to a stream (with default formatting flags).
+// Returns 0 if the object can not be serialized (and config.catchExceptions is true).
+template<typename Format, typename T>
+std::size_t exportSize(T const& value, PrinterInterface::PrinterConfig config = PrinterInterface::PrinterConfig{})
+{
+    SizeOutputBuffer    buffer;
+    std::ostream        stream(&buffer);
+    stream << Exporter<Format, T>(value, config);
+    return stream ? buffer.size() : 0;
+}
+
+// Serialize into a string.
+// A sizing pass is done first so the string is allocated exactly once at its final size.
+// Returns an empty string if the object can not be serialized (and config.catchExceptions is true).
+template<typename Format, typename T>
+std::string exportToString(T const& value, PrinterInterface::PrinterConfig config = PrinterInterface::PrinterConfig{})
+{
+    std::string         result;
+    std::size_t         size = exportSize<Format>(value, config);
+    if (size == 0)
+    {
+        return result;
+    }
+    result.reserve(size);
+
+    StringOutputBuffer  buffer(result);
+    std::ostream        stream(&buffer);
+    stream << Exporter<Format, T>(value, config);
+    if (!stream)
+    {
+        result.clear();
+    }
+    return result;
+}
+
 
     }
 }
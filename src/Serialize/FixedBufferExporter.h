@@ -0,0 +1,137 @@
+#ifndef THORS_ANVIL_SERIALIZE_FIXED_BUFFER_EXPORTER_H
+#define THORS_ANVIL_SERIALIZE_FIXED_BUFFER_EXPORTER_H
+/*
+ * Serialize into a caller provided fixed size buffer (for latency critical code).
+ *
+ * Usage:
+ *      JsonBufferExporter  exporter;                   // Create once and re-use.
+ *      char                buffer[1024];
+ *      std::size_t         size;
+ *      switch (exporter.print(quote, buffer, size))
+ *      {
+ *          case ExportStatus::OK:          send(socket, buffer, size); break;
+ *          case ExportStatus::Overflow:    // buffer was too small.
+ *          case ExportStatus::Failed:      // object could not be serialized (e.g. bad enum value).
+ *      }
+ *
+ * The exporter owns the stream and printer so they are built once. After the first few
+ * messages (when the printer's internal state has grown to the nesting depth of the
+ * object) printing a message does not allocate.
+ *
+ * Overflow is reported by the return value (it never throws). When the buffer is full
+ * the stream fails and the serializer stops at the next member or element
+ * (see PrinterInterface::outputFailed()).
+ *
+ * Note: The printers are written in terms of std::ostream. The stream here sits on a
+ * FixedOutputBuffer that writes directly into the caller's memory (no intermediate buffer).
+ */
+
+#include "JsonThor.h"
+#include "BsonThor.h"
+#include "ThorsLogging/ThorsLogging.h"
+#include <cstddef>
+#include <ostream>
+#include <type_traits>
+
+namespace ThorsAnvil
+{
+    namespace Serialize
+    {
+
+enum class ExportStatus {OK, Overflow, Failed};
+
+template<typename Format>
+class FixedBufferExporter
+{
+    using PrinterConfig = PrinterInterface::PrinterConfig;
+    using Printer       = typename Format::Printer;
+
+    PrinterConfig       config;
+    FixedOutputBuffer   buffer;
+    std::ostream        stream;
+    Printer             printer;
+
+    template<typename T>
+    void printValue(T const& value)
+    {
+        printer.reset();
+        if constexpr (std::is_same<Format, Bson>::value)
+        {
+            printer.config.parserInfo = static_cast<long>(BsonBaseTypeGetter<T>::value);
+            BsonBaseTypeGetter<T>::validate(value);
+        }
+        Serializer  serializer(printer);
+        serializer.print(value);
+    }
+    public:
+        FixedBufferExporter(PrinterConfig config = PrinterConfig{})
+            : config(config)
+            , stream(&buffer)
+            , printer(stream, config)
+        {}
+        FixedBufferExporter(FixedBufferExporter const&)             = delete;
+        FixedBufferExporter& operator=(FixedBufferExporter const&)  = delete;
+
+        // Serialize value into [output, output + capacity).
+        // On success size is the number of bytes used.
+        template<typename T>
+        ExportStatus print(T const& value, char* output, std::size_t capacity, std::size_t& size)
+        {
+            size = 0;
+            buffer.reset(output, output + capacity);
+            stream.clear();
+            try
+            {
+                printValue(value);
+            }
+            catch (ThorsAnvil::Logging::CriticalException const& e)
+            {
+                ThorsCatchMessage("ThorsAnvil::Serialize::FixedBufferExporter", "print", e.what());
+                ThorsRethrowMessage("ThorsAnvil::Serialize::FixedBufferExporter", "print", e.what());
+                throw;
+            }
+            catch (std::exception const& e)
+            {
+                ThorsCatchMessage("ThorsAnvil::Serialize::FixedBufferExporter", "print", e.what());
+                if (!config.catchExceptions)
+                {
+                    ThorsRethrowMessage("ThorsAnvil::Serialize::FixedBufferExporter", "print", e.what());
+                    throw;
+                }
+                return ExportStatus::Failed;
+            }
+            catch (...)
+            {
+                ThorsCatchMessage("ThorsAnvil::Serialize::FixedBufferExporter", "print", "UNKNOWN");
+                if (!config.catchExceptions)
+                {
+                    ThorsRethrowMessage("ThorsAnvil::Serialize::FixedBufferExporter", "print", "UNKNOWN");
+                    throw;
+                }
+                return ExportStatus::Failed;
+            }
+            if (buffer.full())
+            {
+                return ExportStatus::Overflow;
+            }
+            if (!stream)
+            {
+                return ExportStatus::Failed;
+            }
+            size = buffer.size();
+            return ExportStatus::OK;
+        }
+        template<typename T, std::size_t N>
+        ExportStatus print(T const& value, char (&output)[N], std::size_t& size)
+        {
+            return print(value, output, N, size);
+        }
+};
+
+using JsonBufferExporter = FixedBufferExporter<Json>;
+using BsonBufferExporter = FixedBufferExporter<Bson>;
+
+    }
+}
+
+#endif
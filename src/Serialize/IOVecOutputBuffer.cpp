@@ -0,0 +1,157 @@
+#include "SerializeConfig.h"
+#include "IOVecOutputBuffer.h"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+
+using namespace ThorsAnvil::Serialize;
+
+HEADER_ONLY_INCLUDE
+IOVecOutputBuffer::IOVecOutputBuffer(std::size_t blockSize, std::size_t referenceMin)
+    : blockSize(std::max<std::size_t>(blockSize, 64))
+    , referenceMin(referenceMin)
+    , blockInUse(0)
+    , flushed(0)
+    , segmentStart(nullptr)
+{}
+
+HEADER_ONLY_INCLUDE
+void IOVecOutputBuffer::addVector(char const* data, std::size_t size)
+{
+    if (size == 0)
+    {
+        return;
+    }
+    // Merge with the previous buffer when they are contiguous.
+    if (vectors.size() > flushed && static_cast<char const*>(vectors.back().iov_base) + vectors.back().iov_len == data)
+    {
+        vectors.back().iov_len += size;
+        return;
+    }
+    vectors.push_back(iovec{const_cast<char*>(data), size});
+}
+
+HEADER_ONLY_INCLUDE
+void IOVecOutputBuffer::closeSegment()
+{
+    addVector(segmentStart, pptr() - segmentStart);
+    segmentStart = pptr();
+}
+
+HEADER_ONLY_INCLUDE
+void IOVecOutputBuffer::addReference(char const* data, std::size_t size)
+{
+    if (size < referenceMin)
+    {
+        xsputn(data, size);
+        return;
+    }
+    closeSegment();
+    addVector(data, size);
+}
+
+HEADER_ONLY_INCLUDE
+IOVecOutputBuffer::int_type IOVecOutputBuffer::overflow(int_type c)
+{
+    closeSegment();
+    // Blocks are never moved or freed (until destruction) so the iovecs that point at them stay valid.
+    if (blockInUse == blocks.size())
+    {
+        blocks.emplace_back(new char[blockSize]);
+    }
+    char* block = blocks[blockInUse++].get();
+    setp(block, block + blockSize);
+    segmentStart = block;
+
+    if (!traits_type::eq_int_type(c, traits_type::eof()))
+    {
+        *pptr() = traits_type::to_char_type(c);
+        pbump(1);
+    }
+    return traits_type::not_eof(c);
+}
+
+HEADER_ONLY_INCLUDE
+std::streamsize IOVecOutputBuffer::xsputn(char_type const* s, std::streamsize n)
+{
+    std::streamsize written = 0;
+    while (written != n)
+    {
+        if (pptr() == epptr())
+        {
+            overflow(traits_type::eof());
+        }
+        std::streamsize count = std::min<std::streamsize>(n - written, epptr() - pptr());
+        std::memcpy(pptr(), s + written, count);
+        pbump(static_cast<int>(count));
+        written += count;
+    }
+    return n;
+}
+
+HEADER_ONLY_INCLUDE
+std::vector<iovec> const& IOVecOutputBuffer::buffers()
+{
+    closeSegment();
+    return vectors;
+}
+
+HEADER_ONLY_INCLUDE
+std::size_t IOVecOutputBuffer::size()
+{
+    closeSegment();
+    std::size_t result = 0;
+    for (std::size_t loop = flushed; loop < vectors.size(); ++loop)
+    {
+        result += vectors[loop].iov_len;
+    }
+    return result;
+}
+
+HEADER_ONLY_INCLUDE
+bool IOVecOutputBuffer::flush(int fd)
+{
+    closeSegment();
+    while (flushed != vectors.size())
+    {
+        int     count   = static_cast<int>(std::min<std::size_t>(vectors.size() - flushed, IOV_MAX));
+        ssize_t result  = ::writev(fd, &vectors[flushed], count);
+        if (result == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        // Skip the buffers that were completely written and adjust a partially written one.
+        std::size_t remaining = result;
+        while (remaining != 0 && remaining >= vectors[flushed].iov_len)
+        {
+            remaining -= vectors[flushed].iov_len;
+            ++flushed;
+        }
+        if (remaining != 0)
+        {
+            vectors[flushed].iov_base   = static_cast<char*>(vectors[flushed].iov_base) + remaining;
+            vectors[flushed].iov_len   -= remaining;
+        }
+    }
+    clear();
+    return true;
+}
+
+HEADER_ONLY_INCLUDE
+void IOVecOutputBuffer::clear()
+{
+    vectors.clear();
+    flushed     = 0;
+    blockInUse  = 0;
+    setp(nullptr, nullptr);
+    segmentStart = nullptr;
+}
@@ -0,0 +1,71 @@
+#ifndef THORS_ANVIL_SERIALIZE_IOVEC_OUTPUT_BUFFER_H
+#define THORS_ANVIL_SERIALIZE_IOVEC_OUTPUT_BUFFER_H
+/*
+ * A scatter/gather output buffer.
+ *
+ * Usage:
+ *      IOVecOutputBuffer   buffer;
+ *      std::ostream        stream(&buffer);
+ *      stream << bsonExporter(object);
+ *      buffer.flush(socket);                   // One writev() call (per IOV_MAX buffers).
+ *
+ * The structure of the document (keys, sizes, punctuation, small values) is copied into
+ * internal fixed size blocks. Large strings (and Bson binary data) that are members of the
+ * object are not copied: an iovec pointing at the member is added instead (see
+ * PrinterInterface::writeStable()). So the object must not be modified or destroyed until
+ * flush() has completed.
+ *
+ * References smaller than referenceMin are copied (an iovec per small string costs more than the copy).
+ */
+
+#include "ThorsSerializerUtil.h"
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <sys/uio.h>
+
+namespace ThorsAnvil
+{
+    namespace Serialize
+    {
+
+class IOVecOutputBuffer: public ReferenceOutputBuffer
+{
+    std::size_t                             blockSize;
+    std::size_t                             referenceMin;
+    std::vector<std::unique_ptr<char[]>>    blocks;
+    std::size_t                             blockInUse;
+    std::vector<iovec>                      vectors;
+    std::size_t                             flushed;
+    char*                                   segmentStart;
+
+    void    closeSegment();
+    void    addVector(char const* data, std::size_t size);
+    public:
+        IOVecOutputBuffer(std::size_t blockSize = 4096, std::size_t referenceMin = 512);
+
+        virtual void addReference(char const* data, std::size_t size) override;
+
+        // The buffers that would be written by flush().
+        std::vector<iovec> const&   buffers();
+        std::size_t                 size();
+
+        // Write everything to fd using writev().
+        // Returns true when all the data has been written (the buffer is then cleared).
+        // Returns false on error (errno is set); for EAGAIN/EWOULDBLOCK call flush() again
+        // when the fd is writable: the data not yet written is kept.
+        bool    flush(int fd);
+        void    clear();
+    protected:
+        virtual int_type        overflow(int_type c) override;
+        virtual std::streamsize xsputn(char_type const* s, std::streamsize n) override;
+};
+
+    }
+}
+
+#if defined(HEADER_ONLY) && HEADER_ONLY == 1
+#include "IOVecOutputBuffer.source"
+#endif
+
+#endif
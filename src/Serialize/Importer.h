@@ -6,6 +6,10 @@
  */
 
 #include "Serialize.h"
+#include "MappedFile.h"
+#include <istream>
+#include <string>
+#include <utility>
 
 namespace ThorsAnvil
 {
@@ -72,6 +76,172 @@ Importer<Format, T> Import(T const& value, ParserInterface::ParserConfig config
     return Importer<Format, T>(value, config);
 }
 
+/*
+ * Result of the tryXXXImport() functions.
+ * Modeled on std::expected<void, ParseError> (which is not available in C++17):
+ *
+ *      ParseResult result = tryJsonImport(stream, value);
+ *      if (!result)
+ *      {
+ *          std::cerr << result.error().message << "\n";
+ *      }
+ */
+struct ParseError
+{
+    enum Code {Syntax, Data};
+    static constexpr std::size_t unknown = static_cast<std::size_t>(-1);
+
+    Code            code;               // Syntax:  The input is not well formed (bad token, unexpected punctuation ...).
+                                        // Data:    Well formed input that could not be read into the object (type mismatch, missing member ...)
+    std::string     message;
+    std::string     path    = "";       // Json-Pointer to the value that failed (e.g. "/statuses/3/user/id"). "" is the whole document.
+    std::size_t     offset  = unknown;  // Byte offset of the input when the error was found (unknown if the stream can not report its position).
+    std::size_t     line    = 0;        // 1 based line and column of offset.
+    std::size_t     column  = 0;        // 0 if not known (only known when the input is in memory).
+
+    // Set line/column from offset: input is the start of the document.
+    void setLocation(char const* input)
+    {
+        if (offset == unknown)
+        {
+            return;
+        }
+        line    = 1;
+        column  = 1;
+        for (char const* loop = input; loop != input + offset; ++loop)
+        {
+            ++column;
+            if (*loop == '\n')
+            {
+                ++line;
+                column = 1;
+            }
+        }
+    }
+};
+class ParseResult
+{
+    bool            ok;
+    ParseError      failure;
+    public:
+        ParseResult()
+            : ok(true)
+            , failure{ParseError::Data, ""}
+        {}
+        ParseResult(ParseError failure)
+            : ok(false)
+            , failure(std::move(failure))
+        {}
+        bool                has_value() const       {return ok;}
+        explicit operator   bool() const            {return ok;}
+        ParseError const&   error() const           {return failure;}
+};
+
+/*
+ * Read value from stream. Errors are returned (not thrown).
+ * config.catchExceptions is ignored.
+ * Note: Errors are still logged (where the exception is thrown and by the root DeSerializer)
+ *       so use the ThorsLogging level to silence them.
+ *
+ * The DeSerializer reports errors with exceptions internally, but they are caught once
+ * at this level (nested levels do not catch and re-throw). The error records the
+ * path to the failing value and the stream offset (see ParseError).
+ */
+template<typename Format, typename T>
+ParseResult tryImport(std::istream& stream, T& value, ParserInterface::ParserConfig config = ParserInterface::ParserConfig{})
+{
+    typename Format::Parser     parser(stream, config);
+    auto failure = [&](char const* message)
+    {
+        ParseError  error{parser.syntaxError() ? ParseError::Syntax : ParseError::Data, message};
+        error.path      = parser.errorPath;
+        error.offset    = parser.errorOffset();
+        stream.setstate(std::ios::failbit);
+        return ParseResult{std::move(error)};
+    };
+    try
+    {
+        DeSerializer                deSerializer(parser);
+
+        deSerializer.parse(value);
+        return ParseResult{};
+    }
+    catch (ThorsAnvil::Logging::CriticalException const& e)
+    {
+        ThorsCatchMessage("ThorsAnvil::Serialize", "tryImport", e.what());
+        ThorsRethrowMessage("ThorsAnvil::Serialize", "tryImport", e.what());
+        throw;
+    }
+    catch (std::exception const& e)
+    {
+        return failure(e.what());
+    }
+    catch (...)
+    {
+        return failure("UNKNOWN");
+    }
+}
+
+/*
+ * Read a whole file into value.
+ * The file is memory mapped (see MappedFile.h) and the parser reads directly from the mapping
+ * (there is no copy into a filebuf).
+ * Returns true on success.
+ */
+template<typename Format, typename T>
+bool importFile(std::string const& path, T& value, ParserInterface::ParserConfig config = ParserInterface::ParserConfig{}, bool hugePages = false)
+{
+    MappedFile          file(path, hugePages);
+    if (!file)
+    {
+        ThorsCatchMessage("ThorsAnvil::Serialize", "importFile", "Failed to map file");
+        if (!config.catchExceptions)
+        {
+            ThorsLogAndThrow("ThorsAnvil::Serialize",
+                             "importFile",
+                             "Failed to map file: ", path);
+        }
+        return false;
+    }
+    MemoryInputBuffer   buffer(file.begin(), file.end());
+    std::istream        stream(&buffer);
+    // Note: Success is not taken from the stream state.
+    //       Some parsers (Yaml) read past the end of the data which sets the failbit.
+    try
+    {
+        typename Format::Parser     parser(stream, config);
+        DeSerializer                deSerializer(parser);
+
+        deSerializer.parse(value);
+        return true;
+    }
+    catch (ThorsAnvil::Logging::CriticalException const& e)
+    {
+        ThorsCatchMessage("ThorsAnvil::Serialize", "importFile", e.what());
+        ThorsRethrowMessage("ThorsAnvil::Serialize", "importFile", e.what());
+        throw;
+    }
+    catch (std::exception const& e)
+    {
+        ThorsCatchMessage("ThorsAnvil::Serialize", "importFile", e.what());
+        if (!config.catchExceptions)
+        {
+            ThorsRethrowMessage("ThorsAnvil::Serialize", "importFile", e.what());
+            throw;
+        }
+    }
+    catch (...)
+    {
+        ThorsCatchMessage("ThorsAnvil::Serialize", "importFile", "UNKNOWN");
+        if (!config.catchExceptions)
+        {
+            ThorsRethrowMessage("ThorsAnvil::Serialize", "importFile", "UNKNOWN");
+            throw;
+        }
+    }
+    return false;
+}
+
 
     }
 }
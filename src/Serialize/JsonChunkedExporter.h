@@ -0,0 +1,435 @@
+#ifndef THORS_ANVIL_SERIALIZE_JSON_CHUNKED_EXPORTER_H
+#define THORS_ANVIL_SERIALIZE_JSON_CHUNKED_EXPORTER_H
+/*
+ * A pull based Json exporter for non-blocking output.
+ *
+ * Usage:
+ *      JsonChunkedExporter<Response>   exporter(response);
+ *      char                            buffer[4096];
+ *      // Each time the socket is writable:
+ *      std::size_t size = exporter.nextChunk(buffer, sizeof(buffer));
+ *      send(socket, buffer, size);
+ *      if (exporter.done()) {...}
+ *
+ * The output is identical to jsonExporter(value, config).
+ *
+ * The exporter walks the object tree with an explicit stack (JsonChunkFrame) rather than the
+ * recursive Serializer, so it can stop after any member or element and resume when more output is needed:
+ *      Arrays (std::vector, std::list, std::set ...):  One element at a time (an iterator is kept).
+ *      Objects with a trait (ThorsAnvil_MakeTrait / ThorsAnvil_ExpandTrait): One member at a time
+ *                                                      (parent members included).
+ * Other values (numbers, strings, pointers, custom serializers, std::map<std::string, V> ...) are
+ * printed in one piece by the Serializer. So the memory used is bounded by the size of the largest
+ * of these values (not the whole document) e.g. {"results": [...], "meta": {...}} is handed out
+ * one element of results at a time.
+ */
+
+#include "JsonThor.h"
+#include "ThorsLogging/ThorsLogging.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ThorsAnvil
+{
+    namespace Serialize
+    {
+
+/* ------------ Which values are walked ------------------------- */
+template<typename T, typename = void>
+struct JsonChunkByElement: std::false_type {};
+template<typename T>
+struct JsonChunkByElement<T, std::void_t<typename T::value_type, decltype(std::begin(std::declval<T const&>()))>>
+    : std::integral_constant<bool, Traits<T>::type == TraitType::Array>
+{};
+
+template<typename M>
+struct JsonChunkIsTuple: std::false_type {};
+template<typename... M>
+struct JsonChunkIsTuple<std::tuple<M...>>: std::true_type {};
+
+template<typename T, typename = void>
+struct JsonChunkByMember: std::false_type {};
+template<typename T>
+struct JsonChunkByMember<T, std::enable_if_t<Traits<T>::type == TraitType::Map || Traits<T>::type == TraitType::Parent>>
+    : JsonChunkIsTuple<std::decay_t<decltype(Traits<T>::getMembers())>>
+{};
+
+template<typename T>
+struct JsonChunkWalk: std::integral_constant<bool, JsonChunkByElement<T>::value || JsonChunkByMember<T>::value> {};
+
+/* ------------ JsonChunkFrame ------------------------- */
+struct JsonChunkStack;
+class JsonChunkFrame
+{
+    public:
+        virtual ~JsonChunkFrame() {}
+        // Print the next part of the value (or push a frame for it).
+        // Returns false when the value is complete.
+        virtual bool printNext(JsonChunkStack& stack) = 0;
+};
+struct JsonChunkStack
+{
+    PrinterInterface&                               printer;
+    std::vector<std::unique_ptr<JsonChunkFrame>>    frames;
+};
+
+template<typename V>
+void jsonChunkPush(JsonChunkStack& stack, V const& value, Projection const* projection);
+
+// Members are printed as Serializer::printEachMember() and SerializeMemberContainer do.
+template<typename T, typename M>
+void jsonChunkMember(JsonChunkStack& stack, T const& object, std::size_t index, std::pair<char const*, M T::*> const& memberInfo)
+{
+    PrinterInterface&   printer = stack.printer;
+    if (!filterMember(object, memberInfo.first, index))
+    {
+        return;
+    }
+    if constexpr (JsonChunkWalk<std::remove_cv_t<M>>::value)
+    {
+        if (printer.outputFailed() || omitMember(printer, object, memberInfo.second))
+        {
+            return;
+        }
+        char const*         name = ThorsAnvil::Serialize::Override<T>::nameOverride(memberInfo.first);
+        Projection const*   selected;
+        if (!Projection::select(printer.projection, name, selected))
+        {
+            return;
+        }
+        printer.addKey(name);
+        jsonChunkPush(stack, object.*(memberInfo.second), selected);
+    }
+    else
+    {
+        Serializer  serializer(printer, false);
+        make_SerializeMember(serializer, printer, object, memberInfo);
+    }
+}
+template<typename T, typename M>
+void jsonChunkMember(JsonChunkStack& stack, T const& object, std::size_t index, std::pair<char const*, M*> const& memberInfo)
+{
+    if (filterMember(object, memberInfo.first, index))
+    {
+        Serializer  serializer(stack.printer, false);
+        make_SerializeMember(serializer, stack.printer, object, memberInfo);
+    }
+}
+
+// The members of T (then the members of its parents) without the surrounding braces.
+template<typename T>
+class JsonChunkMembersFrame: public JsonChunkFrame
+{
+    using Members = std::decay_t<decltype(Traits<T>::getMembers())>;
+    static constexpr std::size_t count = std::tuple_size<Members>::value;
+
+    T const&        object;
+    std::size_t     index;
+    bool            parentsDone;
+
+    template<std::size_t I>
+    static void printMember(JsonChunkStack& stack, T const& object)
+    {
+        jsonChunkMember(stack, object, I, std::get<I>(Traits<T>::getMembers()));
+    }
+    template<std::size_t... Seq>
+    void printMember(JsonChunkStack& stack, std::index_sequence<Seq...> const&)
+    {
+        using Printer = void (*)(JsonChunkStack&, T const&);
+        static constexpr Printer printers[] = {&printMember<Seq>...};
+        printers[index++](stack, object);
+    }
+    template<typename P>
+    void pushParents(JsonChunkStack& stack, P*)
+    {
+        stack.frames.emplace_back(std::make_unique<JsonChunkMembersFrame<P>>(static_cast<P const&>(object)));
+    }
+    template<typename... P>
+    void pushParents(JsonChunkStack& stack, Parents<P...>*)
+    {
+        // Pushed last to first so the first parent is printed first.
+        std::unique_ptr<JsonChunkFrame> parents[] = {std::make_unique<JsonChunkMembersFrame<P>>(static_cast<P const&>(object))...};
+        for (std::size_t loop = sizeof...(P); loop != 0; --loop)
+        {
+            stack.frames.emplace_back(std::move(parents[loop - 1]));
+        }
+    }
+    public:
+        JsonChunkMembersFrame(T const& object)
+            : object(object)
+            , index(0)
+            , parentsDone(false)
+        {}
+        virtual bool printNext(JsonChunkStack& stack) override
+        {
+            if constexpr (count != 0)
+            {
+                if (index != count)
+                {
+                    printMember(stack, std::make_index_sequence<count>());
+                    return true;
+                }
+            }
+            if constexpr (Traits<T>::type == TraitType::Parent)
+            {
+                if (!parentsDone)
+                {
+                    parentsDone = true;
+                    pushParents(stack, static_cast<typename Traits<T>::Parent*>(nullptr));
+                    return true;
+                }
+            }
+            return false;
+        }
+};
+
+template<typename T>
+class JsonChunkMapFrame: public JsonChunkFrame
+{
+    T const&                            object;
+    ProjectionScope<PrinterInterface>   scope;
+    bool                                open;
+    public:
+        JsonChunkMapFrame(PrinterInterface& printer, T const& object, Projection const* projection)
+            : object(object)
+            , scope(printer, projection)
+            , open(false)
+        {}
+        virtual bool printNext(JsonChunkStack& stack) override
+        {
+            PrinterInterface&   printer = stack.printer;
+            if (!open)
+            {
+                open = true;
+                printer.openMap(printer.printerUsesSize() ? Traits<T>::getPrintSize(printer, object, false) : 0);
+                stack.frames.emplace_back(std::make_unique<JsonChunkMembersFrame<T>>(object));
+                return true;
+            }
+            printer.closeMap();
+            return false;
+        }
+};
+
+template<typename C>
+class JsonChunkArrayFrame: public JsonChunkFrame
+{
+    using Iterator  = decltype(std::begin(std::declval<C const&>()));
+    using Value     = typename C::value_type;
+
+    C const&                            object;
+    ProjectionScope<PrinterInterface>   scope;
+    bool                                open;
+    Iterator                            next;
+    public:
+        JsonChunkArrayFrame(PrinterInterface& printer, C const& object, Projection const* projection)
+            : object(object)
+            , scope(printer, projection)
+            , open(false)
+            , next()
+        {}
+        virtual bool printNext(JsonChunkStack& stack) override
+        {
+            PrinterInterface&   printer = stack.printer;
+            if (!open)
+            {
+                open = true;
+                printer.openArray(printer.printerUsesSize() ? Traits<C>::getPrintSize(printer, object, false) : 0);
+                next = std::begin(object);
+                return true;
+            }
+            if (next == std::end(object))
+            {
+                printer.closeArray();
+                return false;
+            }
+            if constexpr (JsonChunkWalk<Value>::value)
+            {
+                Value const& element = *next;
+                if (!printer.outputFailed())
+                {
+                    jsonChunkPush(stack, element, printer.projection);
+                }
+            }
+            else
+            {
+                PutValueType<Value>     valuePutter(printer);
+                valuePutter.putValue(*next);
+            }
+            ++next;
+            return true;
+        }
+};
+
+template<typename V>
+void jsonChunkPush(JsonChunkStack& stack, V const& value, Projection const* projection)
+{
+    if constexpr (JsonChunkByElement<V>::value)
+    {
+        stack.frames.emplace_back(std::make_unique<JsonChunkArrayFrame<V>>(stack.printer, value, projection));
+    }
+    else
+    {
+        stack.frames.emplace_back(std::make_unique<JsonChunkMapFrame<V>>(stack.printer, value, projection));
+    }
+}
+
+template<typename T>
+class JsonChunkedExporter
+{
+    enum State {Start, Walking, Finished, Failed};
+
+    using PrinterConfig = PrinterInterface::PrinterConfig;
+
+    T const&            value;
+    PrinterConfig       config;
+    State               state;
+    std::string         pending;
+    std::size_t         pendingOffset;
+    StringOutputBuffer  pendingBuffer;
+    std::ostream        pendingStream;
+    JsonPrinter         printer;
+    JsonChunkStack      stack;
+
+    // Print the next piece of the document into pending.
+    void printNext()
+    {
+        pending.clear();
+        pendingOffset = 0;
+        switch (state)
+        {
+            case Start:
+                if constexpr (JsonChunkWalk<T>::value)
+                {
+                    printer.openDoc();
+                    jsonChunkPush(stack, value, printer.projection);
+                    state   = Walking;
+                }
+                else
+                {
+                    Serializer  serializer(printer);
+                    serializer.print(value);
+                    state   = Finished;
+                }
+                break;
+            case Walking:
+                if (stack.frames.empty())
+                {
+                    printer.closeDoc();
+                    state   = Finished;
+                }
+                else if (!stack.frames.back()->printNext(stack))
+                {
+                    stack.frames.pop_back();
+                }
+                break;
+            case Finished:
+            case Failed:
+                break;
+        }
+    }
+    public:
+        JsonChunkedExporter(T const& value, PrinterConfig config = PrinterConfig{})
+            : value(value)
+            , config(config)
+            , state(Start)
+            , pendingOffset(0)
+            , pendingBuffer(pending)
+            , pendingStream(&pendingBuffer)
+            , printer(pendingStream, config)
+            , stack{printer, {}}
+        {}
+        JsonChunkedExporter(JsonChunkedExporter const&)             = delete;
+        JsonChunkedExporter& operator=(JsonChunkedExporter const&)  = delete;
+
+        // Fill buffer with up to maxBytes of the document.
+        // Returns the number of bytes written (0 when done() or failed()).
+        std::size_t nextChunk(char* buffer, std::size_t maxBytes)
+        {
+            std::size_t size = 0;
+            try
+            {
+                while (size < maxBytes)
+                {
+                    if (pendingOffset == pending.size())
+                    {
+                        if (state == Finished || state == Failed)
+                        {
+                            break;
+                        }
+                        printNext();
+                        continue;
+                    }
+                    std::size_t count = std::min(maxBytes - size, pending.size() - pendingOffset);
+                    std::memcpy(buffer + size, pending.data() + pendingOffset, count);
+                    size            += count;
+                    pendingOffset   += count;
+                }
+            }
+            catch (ThorsAnvil::Logging::CriticalException const& e)
+            {
+                ThorsCatchMessage("ThorsAnvil::Serialize::JsonChunkedExporter", "nextChunk", e.what());
+                ThorsRethrowMessage("ThorsAnvil::Serialize::JsonChunkedExporter", "nextChunk", e.what());
+                state = Failed;
+                throw;
+            }
+            catch (std::exception const& e)
+            {
+                ThorsCatchMessage("ThorsAnvil::Serialize::JsonChunkedExporter", "nextChunk", e.what());
+                state = Failed;
+                if (!config.catchExceptions)
+                {
+                    ThorsRethrowMessage("ThorsAnvil::Serialize::JsonChunkedExporter", "nextChunk", e.what());
+                    throw;
+                }
+            }
+            catch (...)
+            {
+                ThorsCatchMessage("ThorsAnvil::Serialize::JsonChunkedExporter", "nextChunk", "UNKNOWN");
+                state = Failed;
+                if (!config.catchExceptions)
+                {
+                    ThorsRethrowMessage("ThorsAnvil::Serialize::JsonChunkedExporter", "nextChunk", "UNKNOWN");
+                    throw;
+                }
+            }
+            return size;
+        }
+        // Append up to maxBytes of the document to output.
+        std::size_t nextChunk(std::string& output, std::size_t maxBytes)
+        {
+            std::size_t start = output.size();
+            output.resize(start + maxBytes);
+            std::size_t size  = nextChunk(&output[start], maxBytes);
+            output.resize(start + size);
+            return size;
+        }
+
+        bool done() const       {return state == Finished && pendingOffset == pending.size();}
+        bool failed() const     {return state == Failed;}
+        // Memory held for output that has not been handed out yet (the most used so far).
+        std::size_t pendingCapacity() const {return pending.capacity();}
+};
+
+// @function-api
+// @param value                     The object to be serialized.
+// @param config                    See jsonExporter().
+// @return                          Object that hands out the Json document in chunks with nextChunk().
+template<typename T>
+JsonChunkedExporter<T> jsonChunkedExporter(T const& value, PrinterInterface::PrinterConfig config = PrinterInterface::PrinterConfig{})
+{
+    return JsonChunkedExporter<T>(value, config);
+}
+
+    }
+}
+
+#endif
@@ -0,0 +1,457 @@
+#ifndef THORS_ANVIL_SERIALIZE_JSON_LINES_H
+#define THORS_ANVIL_SERIALIZE_JSON_LINES_H
+/*
+ * Defines the Json Lines (NDJSON) interface
+ *      ThorsAnvil::Serialize::jsonLinesExporter
+ *      ThorsAnvil::Serialize::jsonLinesImporter
+ *
+ * Usage:
+ *      std::cout << jsonLinesExporter(container);                  // One Json document per line.
+ *      for (auto& record: jsonLinesImporter<Record>(std::cin))     // One Json document per line (or any white space).
+ *      {
+ *          use(record);
+ *      }
+ *
+ * The importer creates one JsonParser and one T for the whole stream and re-uses them for every record.
+ * Before each record the object is reset with JsonLinesReset<T> (containers in T are appended to by the
+ * parser so values from the previous record would otherwise leak into the next record). The reset is done
+ * in place so the buffers of strings and containers keep their capacity between records:
+ *      Types with clear()      =>  value.clear()
+ *      Map/Parent traits types =>  Each non static member in the trait (and each parent) is reset.
+ *      Anything else           =>  Moved from a default constructed T (so default member initializers apply).
+ * Note: Members of a Map type that are not listed in the trait are not reset.
+ *       Containers are emptied (not set to the contents of a default member initializer).
+ *       Specialize JsonLinesReset<T> if a type needs something different.
+ * Elements of a cleared container are destroyed (only the container's own buffer is kept).
+ * The reference returned by the iterator is always the same object so take a copy if you need to keep a record.
+ *
+ * On a parse error the failbit is set on the stream and the iteration stops
+ * (unless config.catchExceptions is false in which case the exception propagates).
+ *
+ * Parallel import of a Json Lines buffer that is already in memory (e.g. a mapped file):
+ *      std::vector<Record>  records;
+ *      bool ok = jsonLinesParallelImport(buffer.data(), buffer.data() + buffer.size(), records);
+ *
+ * The buffer is split into one chunk per thread. Chunks are only split at '\n' so in this mode
+ * each document must be on a single line (a '\n' can only appear inside a Json string as "\\n").
+ * Each chunk is parsed on its own thread with its own JsonLinesImporter (i.e. its own parser and T).
+ * jsonLinesParallelImportChunks() returns the per chunk vectors; jsonLinesParallelImport()
+ * moves them into a single vector in the original order.
+ */
+
+#include "JsonThor.h"
+#include "ThorsLogging/ThorsLogging.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <istream>
+#include <iterator>
+#include <ostream>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace ThorsAnvil
+{
+    namespace Serialize
+    {
+
+/* ------------ JsonLinesReset ------------------------- */
+// reset(value, fresh): Make value look like fresh (a default constructed T) without
+// releasing the buffers held by value.
+template<typename T, typename = void>
+struct JsonLinesReset;
+
+template<typename T>
+struct JsonLinesResetMembers
+{
+    template<typename M>
+    static void resetMember(T&, T&, M* /*staticObjPtr*/)    {}
+    template<typename M>
+    static void resetMember(T& object, T& fresh, M T::* memPtr)
+    {
+        JsonLinesReset<M>::reset(object.*memPtr, fresh.*memPtr);
+    }
+
+    template<typename P>
+    static void resetParent(T& object, T& fresh, P*)
+    {
+        JsonLinesReset<P>::reset(static_cast<P&>(object), static_cast<P&>(fresh));
+    }
+    template<typename... P>
+    static void resetParent(T& object, T& fresh, Parents<P...>*)
+    {
+        bool ignore[] = {true, (JsonLinesReset<P>::reset(static_cast<P&>(object), static_cast<P&>(fresh)), true)...};
+        (void)ignore;
+    }
+
+    template<typename Members, std::size_t... Seq>
+    static void resetEachMember(T& object, T& fresh, Members const& members, std::index_sequence<Seq...> const&)
+    {
+        bool ignore[] = {true, (resetMember(object, fresh, std::get<Seq>(members).second), true)...};
+        (void)ignore;
+    }
+    static void reset(T& object, T& fresh)
+    {
+        if constexpr (Traits<T>::type == TraitType::Parent)
+        {
+            resetParent(object, fresh, static_cast<typename Traits<T>::Parent*>(nullptr));
+        }
+        using Members = std::decay_t<decltype(Traits<T>::getMembers())>;
+        resetEachMember(object, fresh, Traits<T>::getMembers(), std::make_index_sequence<std::tuple_size<Members>::value>());
+    }
+};
+
+template<typename T, typename>
+struct JsonLinesReset
+{
+    static void reset(T& value)
+    {
+        T   fresh{};
+        reset(value, fresh);
+    }
+    static void reset(T& value, T& fresh)
+    {
+        if constexpr (Traits<T>::type == TraitType::Map || Traits<T>::type == TraitType::Parent)
+        {
+            JsonLinesResetMembers<T>::reset(value, fresh);
+        }
+        else
+        {
+            value = std::move(fresh);
+        }
+    }
+};
+template<typename T>
+struct JsonLinesReset<T, std::void_t<decltype(std::declval<T&>().clear())>>
+{
+    static void reset(T& value)             {value.clear();}
+    static void reset(T& value, T& /*fresh*/) {value.clear();}
+};
+
+template<typename T>
+class JsonLinesImporter
+{
+    using ParserConfig = ParserInterface::ParserConfig;
+    std::istream&   stream;
+    ParserConfig    config;
+    JsonParser      parser;
+    T               value;
+
+    public:
+        class iterator
+        {
+            JsonLinesImporter*  importer;
+            public:
+                using iterator_category = std::input_iterator_tag;
+                using value_type        = T;
+                using difference_type   = std::ptrdiff_t;
+                using pointer           = T*;
+                using reference         = T&;
+
+                iterator(JsonLinesImporter* importer = nullptr)
+                    : importer(importer)
+                {}
+                T&          operator*()  const                  {return importer->value;}
+                T*          operator->() const                  {return &importer->value;}
+                iterator&   operator++()
+                {
+                    if (!importer->next())
+                    {
+                        importer = nullptr;
+                    }
+                    return *this;
+                }
+                bool        operator==(iterator const& rhs) const {return importer == rhs.importer;}
+                bool        operator!=(iterator const& rhs) const {return importer != rhs.importer;}
+        };
+
+        JsonLinesImporter(std::istream& stream, ParserConfig config = ParserConfig{})
+            : stream(stream)
+            , config(config)
+            , parser(stream, config)
+            , value{}
+        {}
+        JsonLinesImporter(JsonLinesImporter const&)             = delete;
+        JsonLinesImporter& operator=(JsonLinesImporter const&)  = delete;
+
+        iterator    begin()     {return iterator(next() ? this : nullptr);}
+        iterator    end()       {return iterator();}
+
+        // Read the next record into the object returned by get().
+        // Returns false at the end of the stream or on error (failbit is set on error).
+        bool next()
+        {
+            if (!stream)
+            {
+                return false;
+            }
+            stream >> std::ws;
+            if (stream.eof())
+            {
+                return false;
+            }
+            try
+            {
+                JsonLinesReset<T>::reset(value);
+                parser.reset();
+                DeSerializer    deSerializer(parser);
+                deSerializer.parse(value);
+                return true;
+            }
+            catch (ThorsAnvil::Logging::CriticalException const& e)
+            {
+                ThorsCatchMessage("ThorsAnvil::Serialize::JsonLinesImporter", "next", e.what());
+                ThorsRethrowMessage("ThorsAnvil::Serialize::JsonLinesImporter", "next", e.what());
+                throw;
+            }
+            catch (std::exception const& e)
+            {
+                ThorsCatchMessage("ThorsAnvil::Serialize::JsonLinesImporter", "next", e.what());
+                stream.setstate(std::ios::failbit);
+                if (!config.catchExceptions)
+                {
+                    ThorsRethrowMessage("ThorsAnvil::Serialize::JsonLinesImporter", "next", e.what());
+                    throw;
+                }
+            }
+            catch (...)
+            {
+                ThorsCatchMessage("ThorsAnvil::Serialize::JsonLinesImporter", "next", "UNKNOWN");
+                stream.setstate(std::ios::failbit);
+                if (!config.catchExceptions)
+                {
+                    ThorsRethrowMessage("ThorsAnvil::Serialize::JsonLinesImporter", "next", "UNKNOWN");
+                    throw;
+                }
+            }
+            return false;
+        }
+        T&  get()   {return value;}
+};
+
+template<typename C>
+class JsonLinesExporter
+{
+    using PrinterConfig = PrinterInterface::PrinterConfig;
+    C const&        container;
+    PrinterConfig   config;
+    public:
+        JsonLinesExporter(C const& container, PrinterConfig config)
+            : container(container)
+            , config(config)
+        {
+            // A record must fit on a single line.
+            this->config.characteristics = PrinterInterface::OutputType::Stream;
+        }
+        friend std::ostream& operator<<(std::ostream& stream, JsonLinesExporter const& data)
+        {
+            try
+            {
+                JsonPrinter     printer(stream, data.config);
+                for (auto const& value: data.container)
+                {
+                    printer.reset();
+                    {
+                        Serializer  serializer(printer);
+                        serializer.print(value);
+                    }
+                    stream << '\n';
+                }
+            }
+            catch (ThorsAnvil::Logging::CriticalException const& e)
+            {
+                ThorsCatchMessage("ThorsAnvil::Serialize::JsonLinesExporter", "operator<<", e.what());
+                ThorsRethrowMessage("ThorsAnvil::Serialize::JsonLinesExporter", "operator<<", e.what());
+                throw;
+            }
+            catch (std::exception const& e)
+            {
+                ThorsCatchMessage("ThorsAnvil::Serialize::JsonLinesExporter", "operator<<", e.what());
+                stream.setstate(std::ios::failbit);
+                if (!data.config.catchExceptions)
+                {
+                    ThorsRethrowMessage("ThorsAnvil::Serialize::JsonLinesExporter", "operator<<", e.what());
+                    throw;
+                }
+            }
+            catch (...)
+            {
+                ThorsCatchMessage("ThorsAnvil::Serialize::JsonLinesExporter", "operator<<", "UNKNOWN");
+                stream.setstate(std::ios::failbit);
+                if (!data.config.catchExceptions)
+                {
+                    ThorsRethrowMessage("ThorsAnvil::Serialize::JsonLinesExporter", "operator<<", "UNKNOWN");
+                    throw;
+                }
+            }
+            return stream;
+        }
+};
+
+// @function-api
+// @param container                 A range of objects. Each object is written as one Json document followed by '\n'.
+// @param config.polymorphicMarker  Jason object name for holding the polymorphic class name of the type. Default: __type
+// @param config.catchExceptions    'false:    exceptions propogate.   'true':   parsing exceptions are stopped.
+// @return                          Object that can be passed to operator<< for serialization.
+// Note: config.characteristics is ignored (output is always 'Stream' so each document is on one line).
+template<typename C>
+JsonLinesExporter<C> jsonLinesExporter(C const& container, PrinterInterface::PrinterConfig config = PrinterInterface::PrinterConfig{})
+{
+    return JsonLinesExporter<C>(container, config);
+}
+// @function-api
+// @param stream                    The stream containing white space separated Json documents.
+// @param config.parseStrictness    'Weak':    ignore missing extra fields. 'Strict': Any missing or extra fields throws exception.
+// @param config.polymorphicMarker  Jason object name for holding the polymorphic class name of the type. Default: __type
+// @param config.catchExceptions    'false:    exceptions propogate.        'true':   parsing exceptions are stopped.
+// @return                          A range (use with range based for) that yields a T& for each document.
+template<typename T>
+JsonLinesImporter<T> jsonLinesImporter(std::istream& stream, ParserInterface::ParserConfig config = ParserInterface::ParserConfig{})
+{
+    return JsonLinesImporter<T>(stream, config);
+}
+
+// Split [begin, end) into at most "count" chunks of similar size.
+// Returns the chunk boundaries: chunk N is [result[N], result[N+1]). Every chunk (except the last) ends with '\n'.
+inline std::vector<char const*> jsonLinesSplit(char const* begin, char const* end, std::size_t count)
+{
+    std::vector<char const*>    bounds{begin};
+    std::size_t                 size = end - begin;
+    for (std::size_t loop = 1; loop < count; ++loop)
+    {
+        char const* target = begin + size * loop / count;
+        if (target < bounds.back())
+        {
+            // The previous chunk ended on a line that was longer than a chunk.
+            continue;
+        }
+        char const* newLine = static_cast<char const*>(std::memchr(target, '\n', end - target));
+        if (newLine == nullptr || newLine + 1 == end)
+        {
+            break;
+        }
+        bounds.push_back(newLine + 1);
+    }
+    bounds.push_back(end);
+    return bounds;
+}
+
+// @function-api
+// @param begin                     Start of a buffer containing one Json document per line.
+// @param end                       End of the buffer.
+// @param chunks                    Output: one vector of objects per chunk (in buffer order).
+// @param config                    See jsonLinesImporter().
+// @param threadCount               Number of threads used. Default (0): std::thread::hardware_concurrency().
+// @return                          true if all chunks were parsed.
+//                                  false if any chunk failed (the chunk holds the records before the error).
+//                                  If config.catchExceptions is false the first exception (in buffer order) is re-thrown.
+template<typename T>
+bool jsonLinesParallelImportChunks(char const* begin, char const* end, std::vector<std::vector<T>>& chunks,
+                                   ParserInterface::ParserConfig config = ParserInterface::ParserConfig{},
+                                   std::size_t threadCount = 0)
+{
+    if (threadCount == 0)
+    {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    std::vector<char const*>        bounds      = jsonLinesSplit(begin, end, threadCount);
+    std::size_t                     chunkCount  = bounds.size() - 1;
+    std::vector<std::exception_ptr> errors(chunkCount);
+    std::vector<char>               failed(chunkCount, 0);
+
+    chunks.clear();
+    chunks.resize(chunkCount);
+    auto parseChunk = [&](std::size_t index)
+    {
+        try
+        {
+            MemoryInputBuffer       buffer(bounds[index], bounds[index + 1]);
+            std::istream            stream(&buffer);
+            JsonLinesImporter<T>    importer(stream, config);
+            for (auto& value: importer)
+            {
+                // Safe: the importer resets the object before reading the next record.
+                chunks[index].push_back(std::move(value));
+            }
+            failed[index] = stream.fail();
+        }
+        catch (...)
+        {
+            errors[index] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread>    workers;
+    workers.reserve(chunkCount);
+    for (std::size_t index = 1; index < chunkCount; ++index)
+    {
+        try
+        {
+            workers.emplace_back(parseChunk, index);
+        }
+        catch (std::system_error const&)
+        {
+            // Could not create a thread: do the work on this thread.
+            parseChunk(index);
+        }
+    }
+    parseChunk(0);
+    for (auto& worker: workers)
+    {
+        worker.join();
+    }
+
+    for (std::size_t index = 0; index < chunkCount; ++index)
+    {
+        if (errors[index])
+        {
+            std::rethrow_exception(errors[index]);
+        }
+    }
+    return std::find(std::begin(failed), std::end(failed), 1) == std::end(failed);
+}
+
+// @function-api
+// @param begin                     Start of a buffer containing one Json document per line.
+// @param end                       End of the buffer.
+// @param result                    Output: replaced with all the objects in buffer order.
+// @param config                    See jsonLinesImporter().
+// @param threadCount               Number of threads used. Default (0): std::thread::hardware_concurrency().
+// @return                          See jsonLinesParallelImportChunks().
+template<typename T>
+bool jsonLinesParallelImport(char const* begin, char const* end, std::vector<T>& result,
+                             ParserInterface::ParserConfig config = ParserInterface::ParserConfig{},
+                             std::size_t threadCount = 0)
+{
+    std::vector<std::vector<T>> chunks;
+    bool                        ok      = jsonLinesParallelImportChunks(begin, end, chunks, config, threadCount);
+    std::size_t                 size    = 0;
+    for (auto const& chunk: chunks)
+    {
+        size += chunk.size();
+    }
+    result.clear();
+    result.reserve(size);
+    for (auto& chunk: chunks)
+    {
+        std::move(std::begin(chunk), std::end(chunk), std::back_inserter(result));
+    }
+    return ok;
+}
+template<typename T>
+bool jsonLinesParallelImport(std::string const& buffer, std::vector<T>& result,
+                             ParserInterface::ParserConfig config = ParserInterface::ParserConfig{},
+                             std::size_t threadCount = 0)
+{
+    return jsonLinesParallelImport(buffer.data(), buffer.data() + buffer.size(), result, config, threadCount);
+}
+
+    }
+}
+
+#endif
@@ -14,6 +14,7 @@ HEADER_ONLY_INCLUDE
 JsonManualLexer::JsonManualLexer(std::istream& str)
     : str(str)
     , lastNull(false)
+    , invalid(false)
 {}
 
 HEADER_ONLY_INCLUDE
@@ -111,6 +112,122 @@ void JsonManualLexer::ignoreRawValue()
     }
 }
 
+namespace
+{
+    // Find the quote that ends the string starting at next (just after the opening quote).
+    // Returns end if there is no closing quote.
+    char const* findStringEnd(char const* next, char const* end)
+    {
+        char const* start = next;
+        for (;;)
+        {
+            char const* quote = static_cast<char const*>(std::memchr(next, '"', end - next));
+            if (quote == nullptr)
+            {
+                return end;
+            }
+            // The quote is escaped if it is preceded by an odd number of back slashes.
+            char const* slash = quote;
+            while (slash != start && slash[-1] == '\\')
+            {
+                --slash;
+            }
+            if ((quote - slash) % 2 == 0)
+            {
+                return quote;
+            }
+            next = quote + 1;
+        }
+    }
+}
+
+HEADER_ONLY_INCLUDE
+void JsonManualLexer::skipContainer()
+{
+    // Stack of the close brackets we are expecting.
+    std::string         closers(1, lastToken == '{' ? '}' : ']');
+    MemoryInputBuffer*  memory = dynamic_cast<MemoryInputBuffer*>(str.rdbuf());
+    if (memory != nullptr)
+    {
+        // The data is in memory: scan it in place.
+        // Strings are skipped with memchr() (vectorized by the standard library).
+        char const* begin   = memory->current();
+        char const* end     = memory->last();
+        for (char const* next = begin; next != end;)
+        {
+            char c = *next++;
+            switch (c)
+            {
+                case '"':
+                    next = findStringEnd(next, end);
+                    if (next == end)
+                    {
+                        error();
+                    }
+                    ++next;
+                    break;
+                case '{':   closers.push_back('}');break;
+                case '[':   closers.push_back(']');break;
+                case '}':
+                case ']':
+                    if (c != closers.back())
+                    {
+                        error();
+                    }
+                    closers.pop_back();
+                    if (closers.empty())
+                    {
+                        memory->consume(next - begin);
+                        return;
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+        error();
+    }
+
+    std::streambuf*     input   = str.rdbuf();
+    for (int next = input->sbumpc(); next != EOF; next = input->sbumpc())
+    {
+        switch (next)
+        {
+            case '"':
+            {
+                bool escaped = false;
+                for (next = input->sbumpc(); next != EOF && (escaped || next != '"'); next = input->sbumpc())
+                {
+                    escaped = !escaped && next == '\\';
+                }
+                if (next == EOF)
+                {
+                    error();
+                }
+                break;
+            }
+            case '{':   closers.push_back('}');break;
+            case '[':   closers.push_back(']');break;
+            case '}':
+            case ']':
+                if (next != closers.back())
+                {
+                    error();
+                }
+                closers.pop_back();
+                if (closers.empty())
+                {
+                    return;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    str.setstate(std::ios::eofbit);
+    error();
+}
+
 HEADER_ONLY_INCLUDE
 std::string JsonManualLexer::getRawString()
 {
@@ -143,6 +260,7 @@ std::string JsonManualLexer::getRawString()
             {
                 if (next < 0x20)
                 {
+                    invalid = true;
                     ThorsLogAndThrow("ThorsAnvil::Serializer::JsonManualLexer",
                                      "getRawString",
                                      "Strings should not contain control characters.");
@@ -170,7 +288,52 @@ std::string JsonManualLexer::getRawString()
 HEADER_ONLY_INCLUDE
 std::string JsonManualLexer::getString()
 {
-    return std::string(make_UnicodeWrapperIterator(std::istreambuf_iterator<char>(str)), make_EndUnicodeWrapperIterator(std::istreambuf_iterator<char>(str)));
+    if (lastToken != ThorsAnvil::Serialize::JSON_STRING)
+    {
+        // Not a string: The UnicodeWrapperIterator reports the mismatch.
+        return std::string(make_UnicodeWrapperIterator(std::istreambuf_iterator<char>(str)), make_EndUnicodeWrapperIterator(std::istreambuf_iterator<char>(str)));
+    }
+    try
+    {
+        return std::string(make_UnicodeWrapperIterator(std::istreambuf_iterator<char>(str)), make_EndUnicodeWrapperIterator(std::istreambuf_iterator<char>(str)));
+    }
+    catch (...)
+    {
+        // Bad escape sequence or unterminated string.
+        invalid = true;
+        throw;
+    }
+}
+
+HEADER_ONLY_INCLUDE
+std::string JsonManualLexer::getTrustedString()
+{
+    std::streambuf*     input   = str.rdbuf();
+    std::string         result;
+
+    input->sbumpc();    // The opening quote.
+    int next = input->sbumpc();
+    while (next != '"' && next != '\\' && next != EOF)
+    {
+        result.push_back(next);
+        next = input->sbumpc();
+    }
+    if (next == '\\')
+    {
+        // The rest of the string has escape sequences: decode them.
+        UnicodePushBackIterator<std::string>    decode(result);
+        bool                                    escaped = false;
+        for (; next != EOF && (escaped || next != '"'); next = input->sbumpc())
+        {
+            escaped = !escaped && next == '\\';
+            decode = static_cast<char>(next);
+        }
+    }
+    if (next == EOF)
+    {
+        str.setstate(std::ios::eofbit);
+    }
+    return result;
 }
 
 HEADER_ONLY_INCLUDE
@@ -199,6 +362,27 @@ bool JsonManualLexer::isLastNull()
     return lastNull;
 }
 
+HEADER_ONLY_INCLUDE
+ParserInterface::ValueKind JsonManualLexer::getValueKind()
+{
+    using ValueKind = ParserInterface::ValueKind;
+    switch (lastToken)
+    {
+        case ThorsAnvil::Serialize::JSON_TRUE:      return ValueKind::Bool;
+        case ThorsAnvil::Serialize::JSON_FALSE:     return ValueKind::Bool;
+        case ThorsAnvil::Serialize::JSON_NULL:      return ValueKind::Null;
+        case ThorsAnvil::Serialize::JSON_STRING:    return ValueKind::String;
+        case ThorsAnvil::Serialize::JSON_NUMBER:
+        {
+            // The number has to be read to know its kind.
+            // readNumber() keeps the result so scan() does not read it again.
+            readNumber();
+            return buffer.find_first_of(".eE") == std::string::npos ? ValueKind::Integer : ValueKind::Float;
+        }
+        default:                                    return ValueKind::Other;
+    }
+}
+
 HEADER_ONLY_INCLUDE
 char JsonManualLexer::readDigits(char next)
 {
@@ -216,7 +400,18 @@ char JsonManualLexer::readDigits(char next)
 HEADER_ONLY_INCLUDE
 void JsonManualLexer::readNumber()
 {
-    buffer.clear();
+    if (!buffer.empty())
+    {
+        // Already read by getValueKind() (yylex() clears the buffer for each token).
+        return;
+    }
+    if (lastToken != ThorsAnvil::Serialize::JSON_NUMBER)
+    {
+        // Valid Json but the wrong type (e.g. a string read into an int).
+        ThorsLogAndThrow("ThorsAnvil::Serialize::JsonManualLexer",
+                         "readNumber",
+                         "The last value was not a number");
+    }
 
     int next = str.get();
 
@@ -283,6 +478,7 @@ void JsonManualLexer::checkFixed(char const* check, std::size_t size)
 HEADER_ONLY_INCLUDE
 void JsonManualLexer::error()
 {
+    invalid = true;
     ThorsLogAndThrow("ThorsAnvil::Serialize::JsonManualLexer",
                      "error",
                      "Invalid Character in Lexer");
@@ -18,15 +18,25 @@ class JsonManualLexer
     int                 lastToken;
     bool                lastBool;
     bool                lastNull;
+    bool                invalid;
     public:
         JsonManualLexer(std::istream& str);
         int yylex();
+        // An error was thrown because the input is not valid Json.
+        bool        failed() const      {return invalid;}
+        void        reset()             {invalid = false;}
 
         void        ignoreRawValue();
+        // The last token was '{' or '['. Move the stream past the matching close bracket.
+        // Only brackets and strings are looked at: the content is not validated.
+        void        skipContainer();
         std::string getRawString();
         std::string getString();
+        // Faster version of getString() for input known to be valid (see ParserConfig::trustedInput).
+        std::string getTrustedString();
         bool        getLastBool();
         bool        isLastNull();
+        ParserInterface::ValueKind getValueKind();
         template<typename T>
         T scan();
     private:
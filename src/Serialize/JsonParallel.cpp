@@ -0,0 +1,100 @@
+#include "SerializeConfig.h"
+#include "JsonParallel.h"
+
+namespace
+{
+    inline bool isSpace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+}
+
+HEADER_ONLY_INCLUDE
+bool ThorsAnvil::Serialize::jsonArrayElements(char const* begin, char const* end, std::vector<JsonElementRange>& elements)
+{
+    elements.clear();
+    while (begin != end && isSpace(*begin))
+    {
+        ++begin;
+    }
+    if (begin == end || *begin++ != '[')
+    {
+        return false;
+    }
+
+    std::size_t     depth   = 0;
+    char const*     start   = nullptr;
+    for (; begin != end; ++begin)
+    {
+        char c = *begin;
+        if (c == '"')
+        {
+            // Skip the string. Brackets and commas inside strings are not structural.
+            if (start == nullptr)
+            {
+                start = begin;
+            }
+            for (++begin; begin != end && *begin != '"'; ++begin)
+            {
+                if (*begin == '\\' && ++begin == end)
+                {
+                    return false;
+                }
+            }
+            if (begin == end)
+            {
+                return false;
+            }
+            continue;
+        }
+        if (depth != 0)
+        {
+            if (c == '{' || c == '[')
+            {
+                ++depth;
+            }
+            else if (c == '}' || c == ']')
+            {
+                --depth;
+            }
+            continue;
+        }
+        switch (c)
+        {
+            case ' ': case '\t': case '\n': case '\r':
+                break;
+            case '{': case '[':
+                start   = start == nullptr ? begin : start;
+                depth   = 1;
+                break;
+            case '}':
+                return false;
+            case ',':
+            case ']':
+                if (start == nullptr)
+                {
+                    // Empty element: "[,]" or "[1,]". But "[]" is an empty array.
+                    if (c == ',' || !elements.empty())
+                    {
+                        return false;
+                    }
+                }
+                else
+                {
+                    elements.emplace_back(start, begin);
+                    start = nullptr;
+                }
+                if (c == ']')
+                {
+                    for (++begin; begin != end && isSpace(*begin); ++begin)
+                    {}
+                    return begin == end;
+                }
+                break;
+            default:
+                start   = start == nullptr ? begin : start;
+                break;
+        }
+    }
+    return false;
+}
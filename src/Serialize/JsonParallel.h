@@ -0,0 +1,350 @@
+#ifndef THORS_ANVIL_SERIALIZE_JSON_PARALLEL_H
+#define THORS_ANVIL_SERIALIZE_JSON_PARALLEL_H
+/*
+ * Parallel de-serialization of a large Json array that is already in memory (e.g. a mapped file).
+ *
+ *      std::vector<Record>  records;
+ *      bool ok = jsonParallelImport(buffer.data(), buffer.data() + buffer.size(), records);
+ *
+ * The buffer must hold a single top level Json array.
+ *
+ * A structural pre-scan (jsonArrayElements()) finds the start and end of every top level element
+ * by tracking only brackets and strings. The result vector is then sized to the number of
+ * elements and worker threads parse the elements directly into their slot in the vector.
+ * Work is handed out in small batches from a shared counter so a thread that finishes early
+ * takes the next batch (rather than a fixed split where one slow range holds everything up).
+ * Each thread has its own JsonParser that is reset for every element.
+ *
+ * The pre-scan does not validate the elements (the parser does that).
+ * std::vector<bool> is rejected at compile time: it packs its elements into shared words so
+ * threads writing different elements would race.
+ *
+ * Parallel serialization of a large random access container (e.g. std::vector<T>):
+ *
+ *      std::cout << jsonParallelExporter(records);
+ *
+ * The container is split into one range per thread. Each thread prints its range with its own
+ * JsonPrinter into a private buffer (the printer is told how many elements precede the range so
+ * separators and indentation are correct). The buffers are then written out in order between the
+ * array brackets. The output is byte-identical to jsonExporter(records).
+ */
+
+#include "JsonThor.h"
+#include "ThorsLogging/ThorsLogging.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <istream>
+#include <iterator>
+#include <ostream>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ThorsAnvil
+{
+    namespace Serialize
+    {
+
+using JsonElementRange = std::pair<char const*, char const*>;
+
+// Find the top level elements of the Json array in [begin, end).
+// Each range starts at the first character of the element and ends at the ',' or ']' that terminates it
+// (so may include trailing white space).
+// Returns false if [begin, end) is not a single array or an element is empty.
+bool jsonArrayElements(char const* begin, char const* end, std::vector<JsonElementRange>& elements);
+
+// @function-api
+// @param begin                     Start of a buffer containing a Json array.
+// @param end                       End of the buffer.
+// @param result                    Output: resized to the number of elements and filled in.
+// @param config                    See jsonImporter().
+// @param threadCount               Number of threads used. Default (0): std::thread::hardware_concurrency().
+// @return                          true on success.
+//                                  false on failure (result has an unspecified number of elements filled in).
+//                                  If config.catchExceptions is false the exception is re-thrown.
+template<typename T>
+bool jsonParallelImport(char const* begin, char const* end, std::vector<T>& result,
+                        ParserInterface::ParserConfig config = ParserInterface::ParserConfig{},
+                        std::size_t threadCount = 0)
+{
+    static_assert(!std::is_same<T, bool>::value,
+                  "std::vector<bool> can not be filled in parallel (its elements share words)");
+
+    std::vector<JsonElementRange>   elements;
+    if (!jsonArrayElements(begin, end, elements))
+    {
+        if (!config.catchExceptions)
+        {
+            ThorsLogAndThrow("ThorsAnvil::Serialize",
+                             "jsonParallelImport",
+                             "Invalid Json Array");
+        }
+        return false;
+    }
+
+    if (threadCount == 0)
+    {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    std::size_t const               count       = elements.size();
+    std::size_t const               batchSize   = std::max<std::size_t>(1, count / (threadCount * 16));
+    threadCount = std::min(threadCount, (count + batchSize - 1) / batchSize);
+
+    result.clear();
+    result.resize(count);
+
+    std::atomic<std::size_t>        nextBatch(0);
+    std::atomic<bool>               failed(false);
+    std::vector<std::exception_ptr> errors(std::max<std::size_t>(threadCount, 1));
+    auto parseElements = [&](std::size_t thread)
+    {
+        try
+        {
+            MemoryInputBuffer       buffer;
+            std::istream            stream(&buffer);
+            JsonParser              parser(stream, config);
+            while (!failed)
+            {
+                std::size_t first = nextBatch.fetch_add(batchSize);
+                if (first >= count)
+                {
+                    break;
+                }
+                std::size_t last  = std::min(count, first + batchSize);
+                for (std::size_t index = first; index < last; ++index)
+                {
+                    buffer.reset(elements[index].first, elements[index].second);
+                    stream.clear();
+                    parser.reset();
+                    DeSerializer    deSerializer(parser);
+                    deSerializer.parse(result[index]);
+                }
+            }
+        }
+        catch (...)
+        {
+            failed = true;
+            errors[thread] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread>        workers;
+    workers.reserve(threadCount);
+    for (std::size_t thread = 1; thread < threadCount; ++thread)
+    {
+        try
+        {
+            workers.emplace_back(parseElements, thread);
+        }
+        catch (std::system_error const&)
+        {
+            // Could not create a thread: the threads we have will pick up the work.
+            break;
+        }
+    }
+    parseElements(0);
+    for (auto& worker: workers)
+    {
+        worker.join();
+    }
+
+    for (auto const& error: errors)
+    {
+        if (!error)
+        {
+            continue;
+        }
+        try
+        {
+            std::rethrow_exception(error);
+        }
+        catch (ThorsAnvil::Logging::CriticalException const& e)
+        {
+            ThorsCatchMessage("ThorsAnvil::Serialize", "jsonParallelImport", e.what());
+            ThorsRethrowMessage("ThorsAnvil::Serialize", "jsonParallelImport", e.what());
+            throw;
+        }
+        catch (std::exception const& e)
+        {
+            ThorsCatchMessage("ThorsAnvil::Serialize", "jsonParallelImport", e.what());
+            if (!config.catchExceptions)
+            {
+                ThorsRethrowMessage("ThorsAnvil::Serialize", "jsonParallelImport", e.what());
+                throw;
+            }
+        }
+        catch (...)
+        {
+            ThorsCatchMessage("ThorsAnvil::Serialize", "jsonParallelImport", "UNKNOWN");
+            if (!config.catchExceptions)
+            {
+                ThorsRethrowMessage("ThorsAnvil::Serialize", "jsonParallelImport", "UNKNOWN");
+                throw;
+            }
+        }
+        return false;
+    }
+    return true;
+}
+template<typename T>
+bool jsonParallelImport(std::string const& buffer, std::vector<T>& result,
+                        ParserInterface::ParserConfig config = ParserInterface::ParserConfig{},
+                        std::size_t threadCount = 0)
+{
+    return jsonParallelImport(buffer.data(), buffer.data() + buffer.size(), result, config, threadCount);
+}
+
+template<typename C>
+class ParallelExporter
+{
+    using PrinterConfig = PrinterInterface::PrinterConfig;
+    using Value         = typename C::value_type;
+    C const&        container;
+    PrinterConfig   config;
+    std::size_t     threadCount;
+
+    static std::size_t chunkBegin(std::size_t chunk, std::size_t chunkCount, std::size_t size)
+    {
+        return size * chunk / chunkCount;
+    }
+    public:
+        ParallelExporter(C const& container, PrinterConfig config, std::size_t threadCount)
+            : container(container)
+            , config(config)
+            , threadCount(threadCount == 0 ? std::max(1u, std::thread::hardware_concurrency()) : threadCount)
+        {}
+        friend std::ostream& operator<<(std::ostream& stream, ParallelExporter const& data)
+        {
+            try
+            {
+                std::size_t const               size        = std::size(data.container);
+                std::size_t const               chunkCount  = std::max<std::size_t>(1, std::min(data.threadCount, size));
+                std::vector<std::string>        buffers(chunkCount);
+                std::vector<std::exception_ptr> errors(chunkCount);
+
+                auto printChunk = [&](std::size_t chunk)
+                {
+                    try
+                    {
+                        StringOutputBuffer  buffer(buffers[chunk]);
+                        std::ostream        output(&buffer);
+                        // Numbers must be formatted exactly as they would be on the real stream.
+                        output.flags(stream.flags());
+                        output.precision(stream.precision());
+                        output.imbue(stream.getloc());
+
+                        std::size_t         first   = chunkBegin(chunk,     chunkCount, size);
+                        std::size_t         last    = chunkBegin(chunk + 1, chunkCount, size);
+                        JsonPrinter         printer(output, data.config);
+                        printer.resumeArray(first);
+
+                        PutValueType<Value> valuePutter(printer);
+                        auto                loop    = std::next(std::begin(data.container), first);
+                        for (std::size_t index = first; index < last; ++index, ++loop)
+                        {
+                            valuePutter.putValue(*loop);
+                        }
+                    }
+                    catch (...)
+                    {
+                        errors[chunk] = std::current_exception();
+                    }
+                };
+
+                std::vector<std::thread>        workers;
+                workers.reserve(chunkCount);
+                for (std::size_t chunk = 1; chunk < chunkCount; ++chunk)
+                {
+                    try
+                    {
+                        workers.emplace_back(printChunk, chunk);
+                    }
+                    catch (std::system_error const&)
+                    {
+                        // Could not create a thread: do the work on this thread.
+                        printChunk(chunk);
+                    }
+                }
+                printChunk(0);
+                for (auto& worker: workers)
+                {
+                    worker.join();
+                }
+                for (auto const& error: errors)
+                {
+                    if (error)
+                    {
+                        std::rethrow_exception(error);
+                    }
+                }
+
+                JsonPrinter     printer(stream, data.config);
+                printer.openDoc();
+                printer.openArray(size);
+                for (auto const& buffer: buffers)
+                {
+                    stream.write(buffer.data(), buffer.size());
+                }
+                printer.closeArray();
+                printer.closeDoc();
+            }
+            catch (ThorsAnvil::Logging::CriticalException const& e)
+            {
+                ThorsCatchMessage("ThorsAnvil::Serialize::ParallelExporter", "operator<<", e.what());
+                ThorsRethrowMessage("ThorsAnvil::Serialize::ParallelExporter", "operator<<", e.what());
+                throw;
+            }
+            catch (std::exception const& e)
+            {
+                ThorsCatchMessage("ThorsAnvil::Serialize::ParallelExporter", "operator<<", e.what());
+                stream.setstate(std::ios::failbit);
+                if (!data.config.catchExceptions)
+                {
+                    ThorsRethrowMessage("ThorsAnvil::Serialize::ParallelExporter", "operator<<", e.what());
+                    throw;
+                }
+            }
+            catch (...)
+            {
+                ThorsCatchMessage("ThorsAnvil::Serialize::ParallelExporter", "operator<<", "UNKNOWN");
+                stream.setstate(std::ios::failbit);
+                if (!data.config.catchExceptions)
+                {
+                    ThorsRethrowMessage("ThorsAnvil::Serialize::ParallelExporter", "operator<<", "UNKNOWN");
+                    throw;
+                }
+            }
+            return stream;
+        }
+};
+
+// @function-api
+// @param container                 A random access container (std::vector, std::deque, std::array ...).
+// @param config                    See jsonExporter().
+// @param threadCount               Number of threads used. Default (0): std::thread::hardware_concurrency().
+// @return                          Object that can be passed to operator<< for serialization.
+template<typename C>
+ParallelExporter<C> jsonParallelExporter(C const& container,
+                                         PrinterInterface::PrinterConfig config = PrinterInterface::PrinterConfig{},
+                                         std::size_t threadCount = 0)
+{
+    static_assert(
+        std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<typename C::const_iterator>::iterator_category>::value,
+        "jsonParallelExporter() requires a random access container"
+    );
+    return ParallelExporter<C>(container, config, threadCount);
+}
+
+    }
+}
+
+#if defined(HEADER_ONLY) && HEADER_ONLY == 1
+#include "JsonParallel.source"
+#endif
+
+#endif
@@ -5,6 +5,7 @@
 #include "ThorsIOUtil/Utility.h"
 #include "ThorsLogging/ThorsLogging.h"
 #include <map>
+#include <cassert>
 #include <cstdlib>
 #include <cstring>
 
@@ -19,29 +20,28 @@ JsonParser::JsonParser(std::istream& stream, ParserConfig config)
     , currentEnd(Done)
     , currentState(Init)
     , started(false)
+    , invalid(false)
+    , badPunctuation(false)
 {}
 
 HEADER_ONLY_INCLUDE
-ParserToken JsonParser::getNextToken()
+void JsonParser::reset()
 {
-    /* Handle States were we are not going to read any more */
-    if (!started)
-    {
-        started = true;
-        return ParserToken::DocStart;
-    }
-    if (currentState == Done)
-    {
-        currentState = Error;
-        return ParserToken::DocEnd;
-    }
-    if (currentState == Error)
-    {
-        return ParserToken::Error;
-    }
+    parrentState.clear();
+    currentEnd      = Done;
+    currentState    = Init;
+    started         = false;
+    invalid         = false;
+    badPunctuation  = false;
+    pushBack        = ParserToken::Error;
+    lexer.reset();
+}
 
+HEADER_ONLY_INCLUDE
+JsonParser::State JsonParser::transition(State state, int token)
+{
     // Convert Lexer tokens into smaller range 0-12
-    static std::map<int, int>   tokenIndex  =
+    static std::map<int, int> const tokenIndex  =
     {
         {0,                                     0},
         {'{',                                   1},
@@ -78,15 +78,47 @@ ParserToken JsonParser::getNextToken()
         /* Done  */ {   Error,  Error,  Error,  Error,  Error,  Error,  Error,  Error,  Error,  Error,  Error,  Error,  Error,  Error   },
     };
 
-    // Read the next token and update the state.
-    int token   = lexer.yylex();
-    int index   = tokenIndex[token];
+    // Note: The table is shared by all parsers (which may be on different threads)
+    //       so it is never modified. Unknown tokens map to 0 (Error).
+    auto find   = tokenIndex.find(token);
+    int  index  = find == tokenIndex.end() ? 0 : find->second;
+
+    return stateTable[state][index];
+}
+
+HEADER_ONLY_INCLUDE
+ParserToken JsonParser::getNextToken()
+{
+    /* Handle States were we are not going to read any more */
+    if (!started)
+    {
+        started = true;
+        return ParserToken::DocStart;
+    }
+    if (currentState == Done)
+    {
+        currentState = Error;
+        return ParserToken::DocEnd;
+    }
+    if (currentState == Error)
+    {
+        return ParserToken::Error;
+    }
+
+    if (config.trustedInput)
+    {
+        return getNextTrustedToken();
+    }
 
-    currentState    = stateTable[currentState][index];
+    int token       = lexer.yylex();
+    currentState    = transition(currentState, token);
     switch (currentState)
     {
         // The states that we actually want to return
         case Error:
+            invalid = true;
+            // Value tokens are put back by the lexer. Punctuation has been read.
+            badPunctuation = token != 0 && std::strchr("{}[],:", token) != nullptr;
             return ParserToken::Error;
         case Key:
             return ParserToken::Key;
@@ -143,22 +175,87 @@ ParserToken JsonParser::getNextToken()
                      "Reached an Unnamed State");
 }
 
+HEADER_ONLY_INCLUDE
+ParserToken JsonParser::getNextTrustedToken()
+{
+    // The input was generated by JsonPrinter so the token sequence is valid.
+    // The state only has to track the container we are in (to tell keys from values).
+    for (;;)
+    {
+        int token = lexer.yylex();
+        assert(transition(currentState, token) != Error);
+
+        switch (token)
+        {
+            case '{':
+                parrentState.push_back(currentEnd);
+                currentEnd      = ValueM;
+                currentState    = OpenM;
+                return ParserToken::MapStart;
+            case '[':
+                parrentState.push_back(currentEnd);
+                currentEnd      = ValueA;
+                currentState    = OpenA;
+                return ParserToken::ArrayStart;
+            case '}':
+            case ']':
+                currentEnd  = currentState    = parrentState.back();
+                parrentState.pop_back();
+                return token == '}' ? ParserToken::MapEnd : ParserToken::ArrayEnd;
+            case ',':
+                currentState = currentEnd == ValueM ? CommaM : CommaA;
+                break;
+            case ':':
+                currentState = Colon;
+                break;
+            default:
+                if (currentState == OpenM || currentState == CommaM)
+                {
+                    currentState = Key;
+                    return ParserToken::Key;
+                }
+                // ValueM, ValueA or Done (a top level value).
+                currentState = currentEnd;
+                return ParserToken::Value;
+        }
+    }
+}
+
 HEADER_ONLY_INCLUDE
 std::string JsonParser::getString()
 {
-    return lexer.getString();
+    return config.trustedInput ? lexer.getTrustedString() : lexer.getString();
 }
 HEADER_ONLY_INCLUDE
 std::string JsonParser::getRawString()
 {
     return lexer.getRawString();
 }
+HEADER_ONLY_INCLUDE
+std::size_t JsonParser::errorOffset()
+{
+    // Point at the unexpected punctuation character (not the character after it).
+    std::size_t offset = ParserInterface::errorOffset();
+    return (badPunctuation && offset != static_cast<std::size_t>(-1) && offset != 0) ? offset - 1 : offset;
+}
+
 HEADER_ONLY_INCLUDE
 void JsonParser::ignoreDataValue()
 {
     lexer.ignoreRawValue();
 }
 
+HEADER_ONLY_INCLUDE
+bool JsonParser::skipContainer()
+{
+    // Jump to the matching close bracket then leave the container
+    // exactly as getNextToken() does for MapEnd/ArrayEnd.
+    lexer.skipContainer();
+    currentEnd  = currentState    = parrentState.back();
+    parrentState.pop_back();
+    return true;
+}
+
 HEADER_ONLY_INCLUDE
 std::string JsonParser::getKey()
 {
@@ -37,10 +37,15 @@ class JsonParser: public ParserInterface
     State               currentEnd;
     State               currentState;
     bool                started;
+    bool                invalid;
+    bool                badPunctuation;
 
     std::string getString();
     std::string getRawString();
 
+    static State    transition(State state, int token);
+    ParserToken     getNextTrustedToken();
+
     template<typename T>
     T scan();
     public:
@@ -50,6 +55,9 @@ class JsonParser: public ParserInterface
         virtual std::string getKey()                            override;
 
         virtual void    ignoreDataValue()                       override;
+        virtual bool    skipContainer()                         override;
+        virtual bool    syntaxError() const                     override {return invalid || lexer.failed();}
+        virtual std::size_t errorOffset()                       override;
 
         virtual void    getValue(short int& value)              override;
         virtual void    getValue(int& value)                    override;
@@ -70,8 +78,12 @@ class JsonParser: public ParserInterface
         virtual void    getValue(std::string& value)            override;
 
         virtual bool    isValueNull()                           override;
+        virtual ValueKind getValueKind()                        override    {return lexer.getValueKind();}
 
         virtual std::string getRawValue()                       override;
+
+        // Prepare to read another document from the same stream (see JsonLinesThor.h).
+        void    reset();
 };
     }
 }
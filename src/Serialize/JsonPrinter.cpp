@@ -119,6 +119,20 @@ JsonPrinter::JsonPrinter(std::ostream& output, PrinterConfig config)
     state.emplace_back(0, TraitType::Value);
 }
 
+HEADER_ONLY_INCLUDE
+void JsonPrinter::reset()
+{
+    state.clear();
+    state.emplace_back(0, TraitType::Value);
+}
+
+HEADER_ONLY_INCLUDE
+void JsonPrinter::resumeArray(std::size_t count)
+{
+    reset();
+    state.emplace_back(static_cast<int>(count), TraitType::Array);
+}
+
 HEADER_ONLY_INCLUDE
 void JsonPrinter::openDoc()
 {}
@@ -218,4 +232,17 @@ HEADER_ONLY_INCLUDE void JsonPrinter::addValue(bool value)                  {out
 HEADER_ONLY_INCLUDE void JsonPrinter::addValue(std::string const& value)    {output << PrefixValue(config.characteristics, state.size(), state.back()) << '"' << EscapeString(value) << '"';}
 HEADER_ONLY_INCLUDE void JsonPrinter::addRawValue(std::string const& value) {output << PrefixValue(config.characteristics, state.size(), state.back()) << value;}
 
+HEADER_ONLY_INCLUDE
+void JsonPrinter::addStableValue(std::string const& value)
+{
+    if (referenceOutput == nullptr || EscapeString::needsEscape(value))
+    {
+        addValue(value);
+        return;
+    }
+    output << PrefixValue(config.characteristics, state.size(), state.back()) << '"';
+    writeStable(value.data(), value.size());
+    output << '"';
+}
+
 HEADER_ONLY_INCLUDE void JsonPrinter::addNull()                             {output << PrefixValue(config.characteristics, state.size(), state.back()) << "null";}
@@ -46,12 +46,18 @@ class JsonPrinter: public PrinterInterface
         virtual void addValue(bool value)                   override;
 
         virtual void addValue(std::string const& value)     override;
+        virtual void addStableValue(std::string const& value) override;
 
         virtual void addRawValue(std::string const& value)  override;
 
         virtual void addNull()                              override;
 
         void addPrefix();
+        // Prepare to write another document to the same stream (see JsonLinesThor.h).
+        void reset();
+        // Continue a top level array that already has "count" elements.
+        // Used to print part of an array into a separate buffer (see JsonParallel.h).
+        void resumeArray(std::size_t count);
 };
 
     }
@@ -0,0 +1,108 @@
+#include "SerializeConfig.h"
+#include "JsonPushImporter.h"
+
+using namespace ThorsAnvil::Serialize;
+
+HEADER_ONLY_INCLUDE
+JsonPushInputBuffer::JsonPushInputBuffer()
+    : pending(nullptr)
+    , pendingSize(0)
+    , previous(0)
+    , parserTurn(false)
+    , endOfInput(false)
+    , stopped(false)
+{}
+
+// Give control to the other thread and wait for it to be given back.
+HEADER_ONLY_INCLUDE
+void JsonPushInputBuffer::handOver(std::unique_lock<std::mutex>& lock)
+{
+    bool    mine    = parserTurn;
+    parserTurn      = !mine;
+    signal.notify_all();
+    signal.wait(lock, [this, mine](){return parserTurn == mine;});
+}
+
+HEADER_ONLY_INCLUDE
+void JsonPushInputBuffer::push(char const* data, std::size_t size)
+{
+    std::unique_lock<std::mutex>    lock(mutex);
+    pending     = data;
+    pendingSize = size;
+    handOver(lock);
+}
+
+HEADER_ONLY_INCLUDE
+void JsonPushInputBuffer::endInput()
+{
+    std::unique_lock<std::mutex>    lock(mutex);
+    endOfInput  = true;
+    handOver(lock);
+}
+
+HEADER_ONLY_INCLUDE
+void JsonPushInputBuffer::restart()
+{
+    std::unique_lock<std::mutex>    lock(mutex);
+    endOfInput  = false;
+}
+
+HEADER_ONLY_INCLUDE
+void JsonPushInputBuffer::stop()
+{
+    std::unique_lock<std::mutex>    lock(mutex);
+    stopped     = true;
+    parserTurn  = true;
+    signal.notify_all();
+}
+
+HEADER_ONLY_INCLUDE
+bool JsonPushInputBuffer::waitForDocument()
+{
+    std::unique_lock<std::mutex>    lock(mutex);
+    signal.wait(lock, [this](){return parserTurn;});
+    previous    = 0;
+    setg(nullptr, nullptr, nullptr);
+    return !stopped;
+}
+
+HEADER_ONLY_INCLUDE
+void JsonPushInputBuffer::documentDone()
+{
+    std::unique_lock<std::mutex>    lock(mutex);
+    pending     = nullptr;
+    parserTurn  = false;
+    signal.notify_all();
+}
+
+HEADER_ONLY_INCLUDE
+JsonPushInputBuffer::int_type JsonPushInputBuffer::underflow()
+{
+    std::unique_lock<std::mutex>    lock(mutex);
+    // Note: The chunk was fully used.
+    //       So the feeding thread can re-use its buffer once it has control.
+    previous += egptr() - eback();
+    setg(nullptr, nullptr, nullptr);
+    while (pending == nullptr)
+    {
+        if (endOfInput || stopped)
+        {
+            return traits_type::eof();
+        }
+        handOver(lock);
+    }
+    char* start = const_cast<char*>(pending);
+    setg(start, start, start + pendingSize);
+    pending = nullptr;
+    return traits_type::to_int_type(*gptr());
+}
+
+HEADER_ONLY_INCLUDE
+JsonPushInputBuffer::pos_type JsonPushInputBuffer::seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which)
+{
+    if (off != 0 || dir != std::ios_base::cur || !(which & std::ios_base::in))
+    {
+        return pos_type(off_type(-1));
+    }
+    return pos_type(previous + (gptr() - eback()));
+}
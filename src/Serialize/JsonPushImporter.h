@@ -0,0 +1,263 @@
+#ifndef THORS_ANVIL_SERIALIZE_JSON_PUSH_IMPORTER_H
+#define THORS_ANVIL_SERIALIZE_JSON_PUSH_IMPORTER_H
+/*
+ * A push based (incremental) Json importer for non-blocking I/O.
+ *
+ * Usage:
+ *      JsonPushImporter<Message>   importer(message);
+ *      // Each time data arrives on the socket:
+ *      switch (importer.feed(buffer, size))
+ *      {
+ *          case PushStatus::NeedMoreData:  break;                      // Wait for the next chunk.
+ *          case PushStatus::Done:          use(message);               // importer.consumed() bytes of the chunk were used.
+ *                                          importer.reset();           // The rest of the chunk belongs to the next document.
+ *                                          break;
+ *          case PushStatus::Error:         log(importer.error());
+ *      }
+ *      // At end of input (needed for a top level number: "12" could be the start of "123").
+ *      importer.finish();
+ *
+ * feed() never throws while waiting for data (unless config.catchExceptions is false
+ * and the document is bad).
+ *
+ * Implementation:
+ *      Each chunk is de-serialized as soon as it is passed to feed(): the lexer, the parser and the
+ *      DeSerializer keep their state between chunks and the document is never buffered.
+ *      The DeSerializer is recursive (its state is its call stack) so it runs on a worker thread
+ *      owned by the importer (started by the first feed() and re-used for each document).
+ *      The two threads never run at the same time: feed() hands the chunk to the worker
+ *      (see JsonPushInputBuffer) and waits until the parser has used all of it or the document
+ *      is complete. So the chunk does not need to live beyond the call to feed() and the
+ *      value may be used on the calling thread once feed() returns Done.
+ *
+ * Cost:
+ *      One thread per importer and two thread hand-offs per chunk.
+ *      Feed large chunks (e.g. whatever a read() on the socket returned), not single bytes.
+ *
+ * reset() part way through a document abandons it (the parser sees the end of the input).
+ */
+
+#include "JsonThor.h"
+#include "ThorsLogging/ThorsLogging.h"
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <istream>
+#include <mutex>
+#include <streambuf>
+#include <string>
+#include <thread>
+
+namespace ThorsAnvil
+{
+    namespace Serialize
+    {
+
+enum class PushStatus {NeedMoreData, Done, Error};
+
+/*
+ * The stream buffer read by the parser (on the worker thread).
+ * When the parser runs out of data underflow() passes control back to the thread
+ * that called feed() and waits for the next chunk.
+ */
+class JsonPushInputBuffer: public std::streambuf
+{
+    std::mutex              mutex;
+    std::condition_variable signal;
+    char const*             pending;        // Chunk waiting for the parser.
+    std::size_t             pendingSize;
+    std::size_t             previous;       // Bytes of this document in earlier chunks.
+    bool                    parserTurn;
+    bool                    endOfInput;
+    bool                    stopped;
+
+    void        handOver(std::unique_lock<std::mutex>& lock);
+    public:
+        JsonPushInputBuffer();
+
+        // Called by the feeding thread: Each waits until the parser needs more data
+        // or has finished the document.
+        void        push(char const* data, std::size_t size);
+        void        endInput();
+        // Start a new document (the parser must not be part way through a document).
+        void        restart();
+        // The worker thread returns from waitForDocument() with false.
+        void        stop();
+        // Bytes of the last chunk used by the parser.
+        std::size_t used() const            {return gptr() - eback();}
+
+        // Called by the worker thread.
+        bool        waitForDocument();
+        void        documentDone();
+    protected:
+        virtual int_type underflow() override;
+        // Only reports the current position in the document (so tellg() works).
+        virtual pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override;
+};
+
+template<typename T>
+class JsonPushImporter
+{
+    using ParserConfig = ParserInterface::ParserConfig;
+    T&                  value;
+    ParserConfig        config;
+    JsonPushInputBuffer input;
+    std::thread         worker;
+    bool                parsing;
+    std::size_t         lastConsumed;
+    PushStatus          status;
+    std::string         errorMessage;
+    std::exception_ptr  failure;
+
+    // Worker thread.
+    void run()
+    {
+        while (input.waitForDocument())
+        {
+            parse();
+            input.documentDone();
+        }
+    }
+    void parse()
+    {
+        try
+        {
+            std::istream        stream(&input);
+            JsonParser          parser(stream, config);
+            {
+                DeSerializer    deSerializer(parser);
+                deSerializer.parse(value);
+            }
+            status = PushStatus::Done;
+        }
+        catch (ThorsAnvil::Logging::CriticalException const& e)
+        {
+            ThorsCatchMessage("ThorsAnvil::Serialize::JsonPushImporter", "parse", e.what());
+            ThorsRethrowMessage("ThorsAnvil::Serialize::JsonPushImporter", "parse", e.what());
+            setError(e.what(), std::current_exception());
+        }
+        catch (std::exception const& e)
+        {
+            ThorsCatchMessage("ThorsAnvil::Serialize::JsonPushImporter", "parse", e.what());
+            setError(e.what(), config.catchExceptions ? nullptr : std::current_exception());
+        }
+        catch (...)
+        {
+            ThorsCatchMessage("ThorsAnvil::Serialize::JsonPushImporter", "parse", "UNKNOWN");
+            setError("UNKNOWN", config.catchExceptions ? nullptr : std::current_exception());
+        }
+    }
+    void setError(std::string const& message, std::exception_ptr exception)
+    {
+        errorMessage    = message;
+        failure         = exception;
+        status          = PushStatus::Error;
+    }
+    // Feeding thread: The exception from the worker is re-thrown here.
+    PushStatus result()
+    {
+        if (failure)
+        {
+            std::exception_ptr  exception = failure;
+            failure = nullptr;
+            ThorsRethrowMessage("ThorsAnvil::Serialize::JsonPushImporter", "feed", errorMessage);
+            std::rethrow_exception(exception);
+        }
+        return status;
+    }
+    void abandon()
+    {
+        if (parsing && status == PushStatus::NeedMoreData)
+        {
+            input.endInput();
+        }
+        parsing = false;
+    }
+    public:
+        JsonPushImporter(T& value, ParserConfig config = ParserConfig{})
+            : value(value)
+            , config(config)
+            , parsing(false)
+            , lastConsumed(0)
+            , status(PushStatus::NeedMoreData)
+        {}
+        ~JsonPushImporter()
+        {
+            if (worker.joinable())
+            {
+                abandon();
+                input.stop();
+                worker.join();
+            }
+        }
+        JsonPushImporter(JsonPushImporter const&)               = delete;
+        JsonPushImporter& operator=(JsonPushImporter const&)    = delete;
+
+        // Add the next chunk of data.
+        PushStatus feed(char const* data, std::size_t size)
+        {
+            lastConsumed = 0;
+            if (status != PushStatus::NeedMoreData || size == 0)
+            {
+                return status;
+            }
+            if (!worker.joinable())
+            {
+                worker = std::thread([this](){run();});
+            }
+            parsing = true;
+            input.push(data, size);
+            lastConsumed = status == PushStatus::NeedMoreData ? size : input.used();
+            return result();
+        }
+        PushStatus feed(std::string const& data)
+        {
+            return feed(data.data(), data.size());
+        }
+        // There is no more data.
+        PushStatus finish()
+        {
+            lastConsumed = 0;
+            if (status != PushStatus::NeedMoreData)
+            {
+                return status;
+            }
+            if (!parsing)
+            {
+                if (!config.catchExceptions)
+                {
+                    ThorsLogAndThrow("ThorsAnvil::Serialize::JsonPushImporter",
+                                     "finish",
+                                     "No Json document");
+                }
+                setError("No Json document", nullptr);
+                return status;
+            }
+            input.endInput();
+            return result();
+        }
+        // Start a new document (the value is re-used).
+        void reset()
+        {
+            abandon();
+            input.restart();
+            lastConsumed    = 0;
+            status          = PushStatus::NeedMoreData;
+            errorMessage.clear();
+            failure         = nullptr;
+        }
+
+        // Number of bytes of the last chunk passed to feed() that were part of the document.
+        std::size_t         consumed() const    {return lastConsumed;}
+        PushStatus          getStatus() const   {return status;}
+        std::string const&  error() const       {return errorMessage;}
+};
+
+    }
+}
+
+#if defined(HEADER_ONLY) && HEADER_ONLY == 1
+#include "JsonPushImporter.source"
+#endif
+
+#endif
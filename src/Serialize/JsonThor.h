@@ -4,11 +4,18 @@
  * Defines the Json Serialization interface
  *      ThorsAnvil::Serialize::Json
  *      ThorsAnvil::Serialize::jsonExporter
+ *      ThorsAnvil::Serialize::jsonExporterToString
+ *      ThorsAnvil::Serialize::jsonExportSize
  *      ThorsAnvil::Serialize::jsonImporter
+ *      ThorsAnvil::Serialize::jsonImportFile
+ *      ThorsAnvil::Serialize::tryJsonImport
  *
  * Usage:
  *      std::cout << jsonExporter(object); // converts object to Json on an output stream
+ *      std::string json = jsonExporterToString(object);   // converts object to Json in a string (allocated once)
+ *      std::size_t size = jsonExportSize(object);          // size of the Json (e.g. for Content-Length)
  *      std::cin  >> jsonImporter(object); // converts Json to a C++ object from an input stream
+ *      jsonImportFile("file", object);    // converts the content of a (memory mapped) file to a C++ object
  */
 
 #include "JsonParser.h"
@@ -39,6 +46,25 @@ Exporter<Json, T> jsonExporter(T const& value, PrinterInterface::PrinterConfig c
 {
     return Exporter<Json, T>(value, config);
 }
+// @function-api
+// @param value                     The object to be serialized.
+// @param config                    See jsonExporter().
+// @return                          The exact size in bytes of the Json that jsonExporter(value, config) produces.
+template<typename T>
+std::size_t jsonExportSize(T const& value, PrinterInterface::PrinterConfig config = PrinterInterface::PrinterConfig{})
+{
+    return exportSize<Json>(value, config);
+}
+// @function-api
+// @param value                     The object to be serialized.
+// @param config                    See jsonExporter().
+// @return                          A string containing the Json. The string is sized by a sizing pass so is allocated once.
+//                                  Empty string on failure (if config.catchExceptions is false the exception propagates).
+template<typename T>
+std::string jsonExporterToString(T const& value, PrinterInterface::PrinterConfig config = PrinterInterface::PrinterConfig{})
+{
+    return exportToString<Json>(value, config);
+}
 template<typename T>
 [[deprecated("Upgrade to use jsonExporter(). It has a more consistent interface. The difference is exceptions are caught by default and you need to manually turn the    m off. Turning the exceptions on/off is now part of the config object rahter than a seprate parameter.")]]
 Exporter<Json, T> jsonExport(T const& value, PrinterInterface::PrinterConfig config = PrinterInterface::PrinterConfig{}, bool catchExceptions = false)
@@ -57,6 +83,55 @@ Importer<Json, T> jsonImporter(T& value, ParserInterface::ParserConfig config =
 {
     return Importer<Json, T>(value, config);
 }
+// @function-api
+// @param path                      The file to read (it is memory mapped).
+// @param value                     The object to be de-serialized.
+// @param config                    See jsonImporter().
+// @param hugePages                 Hint that huge pages should be used for the mapping (for very large files).
+// @return                          true on success.
+template<typename T>
+bool jsonImportFile(std::string const& path, T& value, ParserInterface::ParserConfig config = ParserInterface::ParserConfig{}, bool hugePages = false)
+{
+    return importFile<Json>(path, value, config, hugePages);
+}
+// @function-api
+// @param stream                    The stream to read from.
+// @param value                     The object to be de-serialized.
+// @param config                    See jsonImporter(). config.catchExceptions is ignored.
+// @return                          ParseResult: converts to true on success. On failure error() describes the problem
+//                                  (message, Json-Pointer path to the failing value and stream offset).
+//                                  Does not throw (the stream failbit is set on failure).
+template<typename T>
+ParseResult tryJsonImport(std::istream& stream, T& value, ParserInterface::ParserConfig config = ParserInterface::ParserConfig{})
+{
+    return tryImport<Json>(stream, value, config);
+}
+// @function-api
+// @param begin                     Start of a buffer containing a Json document.
+// @param end                       End of the buffer.
+// @param value                     The object to be de-serialized.
+// @param config                    See jsonImporter(). config.catchExceptions is ignored.
+// @return                          ParseResult: See above.
+//                                  The error also has the line and column.
+template<typename T>
+ParseResult tryJsonImport(char const* begin, char const* end, T& value, ParserInterface::ParserConfig config = ParserInterface::ParserConfig{})
+{
+    MemoryInputBuffer   buffer(begin, end);
+    std::istream        stream(&buffer);
+    ParseResult         result = tryImport<Json>(stream, value, config);
+    if (!result)
+    {
+        ParseError      error = result.error();
+        error.setLocation(begin);
+        return error;
+    }
+    return result;
+}
+template<typename T>
+ParseResult tryJsonImport(std::string const& input, T& value, ParserInterface::ParserConfig config = ParserInterface::ParserConfig{})
+{
+    return tryJsonImport(input.data(), input.data() + input.size(), value, config);
+}
 template<typename T>
 [[deprecated("Upgrade to use jsonImporter(). It has a more consistent interface. The difference is exceptions are caught by default and you need to manually turn the    m off. Turning the exceptions on/off is now part of the config object rahter than a seprate parameter.")]]
 Importer<Json, T> jsonImport(T& value, ParserInterface::ParserConfig config = ParserInterface::ParserConfig{}, bool catchExceptions = false)
@@ -0,0 +1,60 @@
+#include "SerializeConfig.h"
+#include "MappedFile.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace ThorsAnvil::Serialize;
+
+HEADER_ONLY_INCLUDE
+MappedFile::MappedFile(std::string const& path, bool hugePages)
+    : mapped(nullptr)
+    , mappedSize(0)
+    , valid(false)
+{
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+    {
+        return;
+    }
+    struct stat info;
+    if (::fstat(fd, &info) == 0 && S_ISREG(info.st_mode))
+    {
+        if (info.st_size == 0)
+        {
+            // mmap() does not allow an empty mapping.
+            valid = true;
+        }
+        else
+        {
+            void* map = ::mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (map != MAP_FAILED)
+            {
+                mapped      = static_cast<char const*>(map);
+                mappedSize  = info.st_size;
+                valid       = true;
+                ::madvise(map, mappedSize, MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+                if (hugePages)
+                {
+                    ::madvise(map, mappedSize, MADV_HUGEPAGE);
+                }
+#else
+                (void)hugePages;
+#endif
+            }
+        }
+    }
+    // The mapping stays valid after the file is closed.
+    ::close(fd);
+}
+
+HEADER_ONLY_INCLUDE
+MappedFile::~MappedFile()
+{
+    if (mapped != nullptr)
+    {
+        ::munmap(const_cast<char*>(mapped), mappedSize);
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef THORS_ANVIL_SERIALIZE_MAPPED_FILE_H
+#define THORS_ANVIL_SERIALIZE_MAPPED_FILE_H
+/*
+ * A read only memory mapping of a whole file.
+ *
+ *      MappedFile  file("data.json");
+ *      if (file) {
+ *          parse(file.begin(), file.end());
+ *      }
+ *
+ * The kernel is told the file will be read sequentially (madvise(MADV_SEQUENTIAL))
+ * so it reads ahead aggressively and drops pages behind the reader.
+ *
+ * hugePages:   Ask for transparent huge pages (madvise(MADV_HUGEPAGE)) to reduce TLB misses on
+ *              very large files. This is only a hint: file backed huge pages depend on the kernel
+ *              and file system, and it is silently ignored where not supported.
+ */
+
+#include <cstddef>
+#include <string>
+
+namespace ThorsAnvil
+{
+    namespace Serialize
+    {
+
+class MappedFile
+{
+    char const*     mapped;
+    std::size_t     mappedSize;
+    bool            valid;
+    public:
+        explicit MappedFile(std::string const& path, bool hugePages = false);
+        ~MappedFile();
+        MappedFile(MappedFile const&)               = delete;
+        MappedFile& operator=(MappedFile const&)    = delete;
+
+        explicit operator bool() const  {return valid;}
+        char const* begin() const       {return mapped;}
+        char const* end() const         {return mapped + mappedSize;}
+        std::size_t size() const        {return mappedSize;}
+};
+
+    }
+}
+
+#if defined(HEADER_ONLY) && HEADER_ONLY == 1
+#include "MappedFile.source"
+#endif
+
+#endif
@@ -0,0 +1,308 @@
+#include "SerializeConfig.h"
+#include "MongoOpMsg.h"
+#include <array>
+
+using namespace ThorsAnvil::Serialize;
+using namespace ThorsAnvil::Serialize::MongoUtility;
+
+namespace
+{
+    // Reflected form of the Castagnoli polynomial 0x1EDC6F41
+    std::array<std::uint32_t, 256> buildCrc32cTable()
+    {
+        std::array<std::uint32_t, 256> table{};
+        for (std::uint32_t loop = 0; loop < 256; ++loop)
+        {
+            std::uint32_t crc = loop;
+            for (int bit = 0; bit < 8; ++bit)
+            {
+                crc = (crc & 1) ? ((crc >> 1) ^ 0x82F63B78) : (crc >> 1);
+            }
+            table[loop] = crc;
+        }
+        return table;
+    }
+}
+
+HEADER_ONLY_INCLUDE
+std::uint32_t ThorsAnvil::Serialize::MongoUtility::crc32c(char const* data, std::size_t size, std::uint32_t crc)
+{
+    static std::array<std::uint32_t, 256> const table = buildCrc32cTable();
+
+    crc = ~crc;
+    for (std::size_t loop = 0; loop < size; ++loop)
+    {
+        crc = table[(crc ^ static_cast<unsigned char>(data[loop])) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+HEADER_ONLY_INCLUDE
+OpMsgBuilder::OpMsgBuilder(std::int32_t requestID, std::int32_t responseTo, std::uint32_t flags)
+    : bufferStream(buffer)
+    , output(&bufferStream)
+{
+    reset(requestID, responseTo, flags);
+}
+
+HEADER_ONLY_INCLUDE
+void OpMsgBuilder::reset(std::int32_t requestID, std::int32_t responseTo, std::uint32_t newFlags)
+{
+    buffer.clear();
+    output.clear();
+    sequenceStart   = std::string::npos;
+    flags           = newFlags;
+    hasBody         = false;
+    finished        = false;
+
+    writeLE<4, std::int32_t>(0);                // messageLength: patched by finish()
+    writeLE<4, std::int32_t>(requestID);
+    writeLE<4, std::int32_t>(responseTo);
+    writeLE<4, std::int32_t>(opMsgOpCode);
+    writeLE<4, std::uint32_t>(flags);
+}
+
+HEADER_ONLY_INCLUDE
+OpMsgBuilder& OpMsgBuilder::openSequence(std::string const& identifier)
+{
+    if (finished || isSequenceOpen())
+    {
+        ThorsLogAndThrow("ThorsAnvil::Serialize::MongoUtility::OpMsgBuilder",
+                         "openSequence",
+                         "Can not open a document sequence: ", (finished ? "message finished" : "sequence already open"));
+    }
+    if (identifier.find('\0') != std::string::npos)
+    {
+        ThorsLogAndThrow("ThorsAnvil::Serialize::MongoUtility::OpMsgBuilder",
+                         "openSequence",
+                         "Sequence identifier can not contain a null character");
+    }
+    buffer.push_back(static_cast<char>(OpMsgSectionKind::DocumentSequence));
+    sequenceStart = buffer.size();
+    writeLE<4, std::int32_t>(0);                // size: patched by closeSequence()
+    buffer.append(identifier.c_str(), identifier.size() + 1);
+    return *this;
+}
+
+HEADER_ONLY_INCLUDE
+OpMsgBuilder& OpMsgBuilder::closeSequence()
+{
+    if (!isSequenceOpen())
+    {
+        ThorsLogAndThrow("ThorsAnvil::Serialize::MongoUtility::OpMsgBuilder",
+                         "closeSequence",
+                         "No document sequence is open");
+    }
+    patchLE<std::int32_t>(sequenceStart, static_cast<std::int32_t>(buffer.size() - sequenceStart));
+    sequenceStart = std::string::npos;
+    return *this;
+}
+
+HEADER_ONLY_INCLUDE
+std::string const& OpMsgBuilder::finish()
+{
+    if (finished)
+    {
+        return buffer;
+    }
+    if (isSequenceOpen())
+    {
+        closeSequence();
+    }
+    if (!hasBody)
+    {
+        ThorsLogAndThrow("ThorsAnvil::Serialize::MongoUtility::OpMsgBuilder",
+                         "finish",
+                         "A message must contain exactly one body section");
+    }
+    bool checksum = flags & OpMsgFlag::ChecksumPresent;
+    patchLE<std::int32_t>(0, static_cast<std::int32_t>(buffer.size() + (checksum ? 4 : 0)));
+    if (checksum)
+    {
+        writeLE<4, std::uint32_t>(crc32c(buffer.data(), buffer.size()));
+    }
+    finished = true;
+    return buffer;
+}
+
+HEADER_ONLY_INCLUDE
+OpMsgReader::OpMsgReader(std::istream& input)
+    : input(input)
+    , flags(0)
+    , messageLeft(0)
+    , sectionLeft(0)
+    , kind(OpMsgSectionKind::Body)
+    , checksum(0)
+    , inSection(false)
+    , bodyRead(false)
+{
+    header.messageLength    = readLE<4, std::int32_t>();
+    header.requestID        = readLE<4, std::int32_t>();
+    header.responseTo       = readLE<4, std::int32_t>();
+    header.opCode           = readLE<4, std::int32_t>();
+    if (header.opCode != opMsgOpCode)
+    {
+        ThorsLogAndThrow("ThorsAnvil::Serialize::MongoUtility::OpMsgReader",
+                         "OpMsgReader",
+                         "Message is not an OP_MSG. opCode: ", header.opCode);
+    }
+    if (header.messageLength < static_cast<std::int32_t>(opMsgHeaderSize + 4))
+    {
+        ThorsLogAndThrow("ThorsAnvil::Serialize::MongoUtility::OpMsgReader",
+                         "OpMsgReader",
+                         "Invalid message length: ", header.messageLength);
+    }
+    flags                   = readLE<4, std::uint32_t>();
+    messageLeft             = header.messageLength - opMsgHeaderSize - 4;
+    if (flags & OpMsgFlag::ChecksumPresent)
+    {
+        if (messageLeft < 4)
+        {
+            ThorsLogAndThrow("ThorsAnvil::Serialize::MongoUtility::OpMsgReader",
+                             "OpMsgReader",
+                             "Message too short to hold a checksum");
+        }
+        messageLeft -= 4;
+    }
+}
+
+HEADER_ONLY_INCLUDE
+void OpMsgReader::skip(std::size_t size)
+{
+    if (size > messageLeft)
+    {
+        ThorsLogAndThrow("ThorsAnvil::Serialize::MongoUtility::OpMsgReader",
+                         "skip",
+                         "Section extends past the end of the message");
+    }
+    if (!input.ignore(size))
+    {
+        ThorsLogAndThrow("ThorsAnvil::Serialize::MongoUtility::OpMsgReader",
+                         "skip",
+                         "Failed to skip data in the stream");
+    }
+    messageLeft -= size;
+}
+
+HEADER_ONLY_INCLUDE
+bool OpMsgReader::nextSection()
+{
+    if (inSection)
+    {
+        // Skip anything the user did not read.
+        if (kind == OpMsgSectionKind::Body)
+        {
+            std::int32_t size = readLE<4, std::int32_t>();
+            messageLeft -= 4;
+            skip(size - 4);
+        }
+        else
+        {
+            skip(sectionLeft);
+        }
+        inSection = false;
+    }
+    if (messageLeft == 0)
+    {
+        if (flags & OpMsgFlag::ChecksumPresent)
+        {
+            // Note: The checksum is read so the stream is positioned at the next message.
+            //       It is not verified as that would require the whole message to be buffered.
+            checksum = readLE<4, std::uint32_t>();
+            flags &= ~static_cast<std::uint32_t>(OpMsgFlag::ChecksumPresent);
+        }
+        return false;
+    }
+
+    char sectionKind;
+    if (!input.get(sectionKind))
+    {
+        ThorsLogAndThrow("ThorsAnvil::Serialize::MongoUtility::OpMsgReader",
+                         "nextSection",
+                         "Failed to read the section kind");
+    }
+    --messageLeft;
+    kind        = static_cast<OpMsgSectionKind>(sectionKind);
+    inSection   = true;
+    identifier.clear();
+    switch (kind)
+    {
+        case OpMsgSectionKind::Body:
+        {
+            if (bodyRead)
+            {
+                ThorsLogAndThrow("ThorsAnvil::Serialize::MongoUtility::OpMsgReader",
+                                 "nextSection",
+                                 "Message contains more than one body section");
+            }
+            break;
+        }
+        case OpMsgSectionKind::DocumentSequence:
+        {
+            std::int32_t size = readLE<4, std::int32_t>();
+            if (!std::getline(input, identifier, '\0'))
+            {
+                ThorsLogAndThrow("ThorsAnvil::Serialize::MongoUtility::OpMsgReader",
+                                 "nextSection",
+                                 "Failed to read the document sequence identifier");
+            }
+            std::size_t headerSize = 4 + identifier.size() + 1;
+            if (size < static_cast<std::int32_t>(headerSize) || static_cast<std::size_t>(size) > messageLeft)
+            {
+                ThorsLogAndThrow("ThorsAnvil::Serialize::MongoUtility::OpMsgReader",
+                                 "nextSection",
+                                 "Invalid document sequence size: ", size);
+            }
+            messageLeft -= headerSize;
+            sectionLeft  = size - headerSize;
+            break;
+        }
+        default:
+        {
+            ThorsLogAndThrow("ThorsAnvil::Serialize::MongoUtility::OpMsgReader",
+                             "nextSection",
+                             "Unknown section kind: ", static_cast<int>(sectionKind));
+        }
+    }
+    return true;
+}
+
+HEADER_ONLY_INCLUDE
+OpMsgInsertBatcher::OpMsgInsertBatcher(std::ostream& output,
+                                       std::string const& db,
+                                       std::string const& collection,
+                                       std::int32_t firstRequestID,
+                                       std::size_t maxMessageSize,
+                                       std::size_t maxBatchCount,
+                                       bool ordered)
+    : output(output)
+    , command{collection, db, ordered}
+    , maxMessageSize(maxMessageSize)
+    , maxBatchCount(maxBatchCount)
+    , nextRequestID(firstRequestID)
+    , builder(firstRequestID)
+{}
+
+HEADER_ONLY_INCLUDE
+void OpMsgInsertBatcher::startMessage()
+{
+    builder.reset(nextRequestID);
+    builder.addBody(command)
+           .openSequence("documents");
+}
+
+HEADER_ONLY_INCLUDE
+void OpMsgInsertBatcher::sendMessage()
+{
+    // Messages are written back to back. The caller reads the replies
+    // afterwards and matches them using getRequestIDs().
+    output << builder;
+    if (!output)
+    {
+        ThorsLogAndThrow("ThorsAnvil::Serialize::MongoUtility::OpMsgInsertBatcher",
+                         "sendMessage",
+                         "Failed to write message to the output stream");
+    }
+    requests.emplace_back(nextRequestID);
+    ++nextRequestID;
+}
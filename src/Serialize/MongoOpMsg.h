@@ -0,0 +1,371 @@
+#ifndef THORS_ANVIL_SERIALIZE_MONGO_OP_MSG_H
+#define THORS_ANVIL_SERIALIZE_MONGO_OP_MSG_H
+/*
+ * Mongo wire protocol OP_MSG framing.
+ *
+ *      OpMsgBuilder:       Serializes objects (anything with Traits<T>) directly into a single message buffer.
+ *      OpMsgReader:        Reads a message from a stream (it does not need to be seekable) section by section.
+ *      OpMsgInsertBatcher: Splits a range of objects into as many "insert" messages as needed and
+ *                          writes them back to back (pipelined) without waiting for the replies.
+ *
+ * Message Layout (all integers are little endian):
+ *      <messageLength int32> <requestID int32> <responseTo int32> <opCode int32 = 2013>
+ *      <flagBits uint32>
+ *      <Section>+
+ *      <checksum uint32>                                               Optional: only if ChecksumPresent is set.
+ *
+ *      Section Kind 0 (body):                  '\x00' <BSON Document>
+ *      Section Kind 1 (document sequence):     '\x01' <size int32> <identifier cstring> <BSON Document>*
+ *
+ * Usage:
+ *      OpMsgBuilder    builder(requestID);
+ *      builder.addBody(command)
+ *             .openSequence("documents")
+ *             .addDocument(doc1)
+ *             .addDocument(doc2)
+ *             .closeSequence();
+ *      socketStream << builder;
+ *
+ *      OpMsgReader     reader(socketStream);
+ *      while (reader.nextSection())
+ *      {
+ *          if (reader.getSectionKind() == OpMsgSectionKind::Body)  {reader.readDocument(reply);}
+ *          else while (reader.readDocument(doc)) {...}
+ *      }
+ */
+
+#include "BsonThor.h"
+#include "BsonParser.h"
+#include "Traits.h"
+#include "ThorsSerializerUtil.h"
+#include "ThorsIOUtil/Utility.h"
+#include "ThorsLogging/ThorsLogging.h"
+#include <boost/endian/conversion.hpp>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ThorsAnvil
+{
+    namespace Serialize
+    {
+        namespace MongoUtility
+        {
+
+enum class OpMsgFlag: std::uint32_t {None = 0, ChecksumPresent = 1 << 0, MoreToCome = 1 << 1, ExhaustAllowed = 1 << 16};
+enum class OpMsgSectionKind: char {Body = '\x00', DocumentSequence = '\x01'};
+
+inline std::uint32_t operator|(OpMsgFlag lhs, OpMsgFlag rhs)       {return static_cast<std::uint32_t>(lhs) | static_cast<std::uint32_t>(rhs);}
+inline std::uint32_t operator|(std::uint32_t lhs, OpMsgFlag rhs)   {return lhs | static_cast<std::uint32_t>(rhs);}
+inline bool          operator&(std::uint32_t lhs, OpMsgFlag rhs)   {return (lhs & static_cast<std::uint32_t>(rhs)) != 0;}
+
+static constexpr std::int32_t   opMsgOpCode             = 2013;
+static constexpr std::size_t    opMsgHeaderSize         = 16;
+static constexpr std::size_t    opMsgDefaultMaxSize     = 48'000'000;
+static constexpr std::size_t    opMsgDefaultMaxBatch    = 100'000;
+
+struct MsgHeader
+{
+    std::int32_t    messageLength   = 0;
+    std::int32_t    requestID       = 0;
+    std::int32_t    responseTo      = 0;
+    std::int32_t    opCode          = opMsgOpCode;
+};
+
+// CRC-32C (Castagnoli) as used by the OP_MSG checksum.
+std::uint32_t crc32c(char const* data, std::size_t size, std::uint32_t crc = 0);
+
+class OpMsgBuilder
+{
+    std::string         buffer;
+    StringOutputBuffer  bufferStream;
+    std::ostream        output;
+    std::size_t         sequenceStart;
+    std::uint32_t       flags;
+    bool                hasBody;
+    bool                finished;
+
+    public:
+        OpMsgBuilder(std::int32_t requestID, std::int32_t responseTo = 0, std::uint32_t flags = 0);
+        OpMsgBuilder(OpMsgBuilder const&)               = delete;
+        OpMsgBuilder& operator=(OpMsgBuilder const&)    = delete;
+
+        // Start a new message re-using the buffer allocated by the previous one.
+        void reset(std::int32_t requestID, std::int32_t responseTo = 0, std::uint32_t flags = 0);
+
+        template<typename T>
+        OpMsgBuilder& addBody(T const& document, PrinterInterface::PrinterConfig config = PrinterInterface::PrinterConfig{});
+
+        OpMsgBuilder& openSequence(std::string const& identifier);
+        template<typename T>
+        OpMsgBuilder& addDocument(T const& document, PrinterInterface::PrinterConfig config = PrinterInterface::PrinterConfig{});
+        template<typename I>
+        OpMsgBuilder& addDocuments(I begin, I end, PrinterInterface::PrinterConfig config = PrinterInterface::PrinterConfig{});
+        OpMsgBuilder& closeSequence();
+
+        bool                isSequenceOpen() const  {return sequenceStart != std::string::npos;}
+        // The size of the message so far (not including an optional checksum).
+        std::size_t         size() const            {return buffer.size();}
+        // Patches the message length (and adds the checksum if required).
+        std::string const&  finish();
+
+        friend std::ostream& operator<<(std::ostream& stream, OpMsgBuilder& builder)
+        {
+            std::string const& message = builder.finish();
+            return stream.write(message.data(), message.size());
+        }
+    private:
+        template<std::size_t size, typename Int>
+        void writeLE(Int value);
+        template<typename Int>
+        void patchLE(std::size_t offset, Int value);
+        template<typename T>
+        void writeDocument(T const& document, PrinterInterface::PrinterConfig config, char const* action);
+};
+
+class OpMsgReader
+{
+    std::istream&   input;
+    MsgHeader       header;
+    std::uint32_t   flags;
+    std::size_t     messageLeft;
+    std::size_t     sectionLeft;
+    OpMsgSectionKind kind;
+    std::string     identifier;
+    std::uint32_t   checksum;
+    bool            inSection;
+    bool            bodyRead;
+
+    public:
+        OpMsgReader(std::istream& input);
+
+        MsgHeader const&    getHeader() const           {return header;}
+        std::uint32_t       getFlags() const            {return flags;}
+        std::uint32_t       getChecksum() const         {return checksum;}
+
+        // Move to the next section (any unread documents in the current section are skipped).
+        // Returns false when there are no more sections (the optional checksum has been read).
+        bool                nextSection();
+        OpMsgSectionKind    getSectionKind() const      {return kind;}
+        std::string const&  getIdentifier() const       {return identifier;}
+
+        // Read the next document from the current section.
+        // Returns false if there are no more documents in this section.
+        template<typename T>
+        bool readDocument(T& document, ParserInterface::ParserConfig config = ParserInterface::ParserConfig{});
+
+    private:
+        template<std::size_t size, typename Int>
+        Int readLE();
+        void skip(std::size_t size);
+};
+
+/*
+ * The command document used by OpMsgInsertBatcher.
+ * Serialized as: {"insert": <collection>, "$db": <db>, "ordered": <ordered>}
+ */
+struct InsertCommand
+{
+    std::string     insert;
+    std::string     db;
+    bool            ordered;
+};
+
+class OpMsgInsertBatcher
+{
+    std::ostream&               output;
+    InsertCommand               command;
+    std::size_t                 maxMessageSize;
+    std::size_t                 maxBatchCount;
+    std::int32_t                nextRequestID;
+    std::vector<std::int32_t>   requests;
+    OpMsgBuilder                builder;
+
+    public:
+        OpMsgInsertBatcher(std::ostream& output,
+                           std::string const& db,
+                           std::string const& collection,
+                           std::int32_t firstRequestID  = 1,
+                           std::size_t maxMessageSize   = opMsgDefaultMaxSize,
+                           std::size_t maxBatchCount    = opMsgDefaultMaxBatch,
+                           bool ordered                 = true);
+
+        // Writes all the documents in the range as one or more messages.
+        // Returns the number of messages written.
+        template<typename I>
+        std::size_t insert(I begin, I end);
+
+        // The requestID of every message written (so replies can be matched via responseTo).
+        std::vector<std::int32_t> const&    getRequestIDs() const   {return requests;}
+    private:
+        void startMessage();
+        void sendMessage();
+};
+
+template<std::size_t size, typename Int>
+inline void OpMsgBuilder::writeLE(Int value)
+{
+    Int docValue = boost::endian::native_to_little(value);
+    buffer.append(reinterpret_cast<char const*>(&docValue), size);
+}
+
+template<typename Int>
+inline void OpMsgBuilder::patchLE(std::size_t offset, Int value)
+{
+    Int docValue = boost::endian::native_to_little(value);
+    buffer.replace(offset, sizeof(Int), reinterpret_cast<char const*>(&docValue), sizeof(Int));
+}
+
+template<typename T>
+inline void OpMsgBuilder::writeDocument(T const& document, PrinterInterface::PrinterConfig config, char const* action)
+{
+    if (finished)
+    {
+        ThorsLogAndThrow("ThorsAnvil::Serialize::MongoUtility::OpMsgBuilder",
+                         action,
+                         "Message has been finished. Call reset() to start a new message");
+    }
+    config.catchExceptions = false;
+    output << bsonExporter(document, config);
+}
+
+template<typename T>
+inline OpMsgBuilder& OpMsgBuilder::addBody(T const& document, PrinterInterface::PrinterConfig config)
+{
+    if (hasBody || isSequenceOpen())
+    {
+        ThorsLogAndThrow("ThorsAnvil::Serialize::MongoUtility::OpMsgBuilder",
+                         "addBody",
+                         "A message has exactly one body section and it can not be inside a document sequence");
+    }
+    hasBody = true;
+    buffer.push_back(static_cast<char>(OpMsgSectionKind::Body));
+    writeDocument(document, config, "addBody");
+    return *this;
+}
+
+template<typename T>
+inline OpMsgBuilder& OpMsgBuilder::addDocument(T const& document, PrinterInterface::PrinterConfig config)
+{
+    if (!isSequenceOpen())
+    {
+        ThorsLogAndThrow("ThorsAnvil::Serialize::MongoUtility::OpMsgBuilder",
+                         "addDocument",
+                         "No document sequence is open. Call openSequence() first");
+    }
+    writeDocument(document, config, "addDocument");
+    return *this;
+}
+
+template<typename I>
+inline OpMsgBuilder& OpMsgBuilder::addDocuments(I begin, I end, PrinterInterface::PrinterConfig config)
+{
+    for (; begin != end; ++begin)
+    {
+        addDocument(*begin, config);
+    }
+    return *this;
+}
+
+template<std::size_t size, typename Int>
+inline Int OpMsgReader::readLE()
+{
+    Int value = 0;
+    if (!input.read(reinterpret_cast<char*>(&value), size))
+    {
+        ThorsLogAndThrow("ThorsAnvil::Serialize::MongoUtility::OpMsgReader",
+                         "readLE",
+                         "Failed to read integer from the stream");
+    }
+    return boost::endian::little_to_native(value);
+}
+
+template<typename T>
+inline bool OpMsgReader::readDocument(T& document, ParserInterface::ParserConfig config)
+{
+    if (!inSection)
+    {
+        return false;
+    }
+    if (kind == OpMsgSectionKind::Body ? bodyRead : sectionLeft == 0)
+    {
+        return false;
+    }
+
+    std::size_t consumed;
+    {
+        // The document size is only known once it has been read.
+        // So count the bytes as they are consumed (this works on non seekable streams).
+        BsonStreamCounter   counter(input);
+        config.catchExceptions = false;
+        input >> bsonImporter(document, config);
+        consumed = counter.consumed();
+    }
+    if (consumed > messageLeft || (kind == OpMsgSectionKind::DocumentSequence && consumed > sectionLeft))
+    {
+        ThorsLogAndThrow("ThorsAnvil::Serialize::MongoUtility::OpMsgReader",
+                         "readDocument",
+                         "Document extends past the end of its section");
+    }
+    messageLeft -= consumed;
+    if (kind == OpMsgSectionKind::Body)
+    {
+        bodyRead    = true;
+        inSection   = false;
+    }
+    else
+    {
+        sectionLeft -= consumed;
+    }
+    return true;
+}
+
+template<typename I>
+inline std::size_t OpMsgInsertBatcher::insert(I begin, I end)
+{
+    std::size_t messages    = 0;
+    std::size_t count       = 0;
+    for (; begin != end; ++begin)
+    {
+        std::size_t docSize = bsonGetPrintSize(*begin);
+        if (count != 0 && (count == maxBatchCount || builder.size() + docSize > maxMessageSize))
+        {
+            sendMessage();
+            ++messages;
+            count = 0;
+        }
+        if (count == 0)
+        {
+            startMessage();
+            if (builder.size() + docSize > maxMessageSize)
+            {
+                ThorsLogAndThrow("ThorsAnvil::Serialize::MongoUtility::OpMsgInsertBatcher",
+                                 "insert",
+                                 "A single document is larger than the maximum message size: ", docSize);
+            }
+        }
+        builder.addDocument(*begin);
+        ++count;
+    }
+    if (count != 0)
+    {
+        sendMessage();
+        ++messages;
+    }
+    return messages;
+}
+
+        }
+    }
+}
+
+ThorsAnvil_MakeOverride(ThorsAnvil::Serialize::MongoUtility::InsertCommand, {"db", "$db"});
+ThorsAnvil_MakeTrait(ThorsAnvil::Serialize::MongoUtility::InsertCommand, insert, db, ordered);
+
+#if defined(HEADER_ONLY) && HEADER_ONLY == 1
+#include "MongoOpMsg.source"
+#endif
+
+#endif
@@ -1,15 +1,64 @@
 #include "MongoUtility.h"
+#include "ChronoUtil.h"
 
 #include <chrono>
 #include <iomanip>
 #include <iostream>
 #include <tuple>
 #include <arpa/inet.h>
+#include <atomic>
+#include <random>
+#include <time.h>
 
 using namespace ThorsAnvil::Serialize;
 using namespace ThorsAnvil::Serialize::MongoUtility;
 
-int ObjectID::classCounter = 32769;
+std::int32_t ObjectID::getTimestamp()
+{
+#if defined(CLOCK_REALTIME_COARSE)
+    timespec    now;
+    if (clock_gettime(CLOCK_REALTIME_COARSE, &now) == 0)
+    {
+        return static_cast<std::int32_t>(now.tv_sec);
+    }
+#endif
+    return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+std::int64_t ObjectID::getProcessRandom()
+{
+    static std::int64_t const processRandom = []()
+    {
+        std::random_device  device;
+        std::int64_t        value = (static_cast<std::int64_t>(device()) << 32) | device();
+        return value & 0xFF'FFFF'FFFFLL;
+    }();
+    return processRandom;
+}
+
+std::int32_t ObjectID::getNextCounter()
+{
+    static std::atomic<std::uint32_t> classCounter{std::random_device{}()};
+
+    struct CounterBlock
+    {
+        std::uint32_t   next    = 0;
+        std::uint32_t   end     = 0;
+    };
+    thread_local CounterBlock   block;
+    if (block.next == block.end)
+    {
+        block.next  = classCounter.fetch_add(counterBlockSize, std::memory_order_relaxed);
+        block.end   = block.next + counterBlockSize;
+    }
+    return static_cast<std::int32_t>(block.next++ & 0xFFFFFF);
+}
+
+ObjectID::ObjectID()
+    : timestamp(getTimestamp())
+    , random(getProcessRandom())
+    , counter(getNextCounter())
+{}
 
 ObjectID::ObjectID(std::int32_t timestamp, std::int64_t random, std::int32_t counter)
     : timestamp(timestamp)
@@ -64,7 +113,25 @@ namespace ThorsAnvil::Serialize::MongoUtility
     }
     JsonPrinter& operator<<(JsonPrinter& printer, UTCDateTime const& data)
     {
-        printer.stream() << ThorsAnvil::Utility::StreamFormatterNoChange{} << std::hex << std::setw(16) << std::setfill('0') << data.datetime;
+        std::int64_t    seconds = data.datetime / 1000;
+        std::int64_t    millis  = data.datetime % 1000;
+        if (millis < 0)
+        {
+            millis += 1000;
+            --seconds;
+        }
+        char        buffer[Chrono::iso8601TimeMaxSize + 2];
+        buffer[0]   = '"';
+        std::size_t size = Chrono::formatISO8601Time(buffer + 1, seconds, static_cast<std::uint32_t>(millis * 1'000'000), 3);
+        if (size == 0)
+        {
+            // Outside the years 0000-9999: Fall back to the original format
+            // (the millisecond count as 16 hex digits) so the reader only has one other format.
+            printer.stream() << ThorsAnvil::Utility::StreamFormatterNoChange{} << std::hex << std::setw(16) << std::setfill('0') << data.datetime;
+            return printer;
+        }
+        buffer[size + 1] = '"';
+        printer.stream().write(buffer, size + 2);
         return printer;
     }
     BsonParser& operator>>(BsonParser& parser, UTCDateTime& data)
@@ -74,7 +141,24 @@ namespace ThorsAnvil::Serialize::MongoUtility
     }
     JsonParser& operator>>(JsonParser& parser, UTCDateTime& data)
     {
-        parser.stream() >> ThorsAnvil::Utility::StreamFormatterNoChange{} >> std::hex >> data.datetime;
+        std::istream&   stream = parser.stream();
+        if ((stream >> std::ws).peek() != '"')
+        {
+            // Written before ISO-8601 support (or out of range): 16 hex digits.
+            stream >> ThorsAnvil::Utility::StreamFormatterNoChange{} >> std::hex >> data.datetime;
+            return parser;
+        }
+        char            buffer[64];
+        std::size_t     size = Chrono::readJsonQuotedValue(stream, buffer, sizeof(buffer));
+        std::int64_t    seconds;
+        std::uint32_t   nanos;
+        if (!Chrono::parseISO8601Time(buffer, buffer + size, seconds, nanos))
+        {
+            ThorsLogAndThrow("ThorsAnvil::Serialize::MongoUtility::UTCDateTime",
+                             "operator>>",
+                             "Invalid ISO-8601 time: ", std::string(buffer, size));
+        }
+        data.datetime = seconds * 1000 + nanos / 1'000'000;
         return parser;
     }
 }
@@ -133,7 +133,7 @@ class BinarySerializer: public DefaultCustomSerializer<T>
             char            type    = encodeType;
             printer.writeLE<4, std::int32_t>(size);
             printer.stream().write(&type, 1);
-            printer.stream().write(object.getBuffer(), object.getSize());
+            printer.writeStable(object.getBuffer(), object.getSize());
         }
         virtual void readBson(BsonParser& parser, char /*byteMarker*/, T& object) const override
         {
@@ -156,7 +156,7 @@ class JavascriptSerializer: public DefaultCustomSerializer<T>
         {
             std::int32_t    size = object.getSize();
             printer.writeLE<4, std::int32_t>(size + 1);
-            printer.stream().write(object.getBuffer(), size);
+            printer.writeStable(object.getBuffer(), size);
             printer.stream().write("", 1);
         }
         virtual void readBson(BsonParser& parser, char /*byteMarker*/, T& object) const override
@@ -194,17 +194,25 @@ class ObjectID
     // 4 byte timestamp
     // 5 byte random
     // 3 byte incrementing counter.
-    static int classCounter; // = rand();
+    //
+    // Generating a new ID is lock free and safe to call from multiple threads:
+    //      The random value is generated once per process.
+    //      Each thread reserves a block of counter values from a shared atomic
+    //      so the shared counter is only touched once every counterBlockSize IDs.
+    //      The timestamp uses the coarse (tick resolution) clock where available
+    //      as only seconds are stored.
+    static constexpr std::uint32_t counterBlockSize = 256;
 
     std::int32_t    timestamp;
     std::int64_t    random;
     std::int32_t    counter;
     public:
-        static int getNextCounter()
-        {
-            return (classCounter++) % 0xFFF;
-        }
-        ObjectID(std::int32_t timestamp = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count(), std::int64_t random = std::rand(), std::int32_t counter = ObjectID::getNextCounter());
+        static std::int32_t getTimestamp();
+        static std::int64_t getProcessRandom();
+        static std::int32_t getNextCounter();
+
+        ObjectID();
+        ObjectID(std::int32_t timestamp, std::int64_t random = ObjectID::getProcessRandom(), std::int32_t counter = ObjectID::getNextCounter());
         bool operator==(ObjectID const& rhs) const {return std::tie(timestamp, random, counter) == std::tie(rhs.timestamp, rhs.random, rhs.counter);}
         bool operator<(ObjectID const& rhs)  const {return std::tie(timestamp, random, counter) <  std::tie(rhs.timestamp, rhs.random, rhs.counter);}
         friend BsonPrinter& operator<<(BsonPrinter& printer, ObjectID const& data);
@@ -215,6 +223,9 @@ class ObjectID
 class UTCDateTime
 {
     // Time in ms since the epoch
+    // Json: ISO-8601 string "YYYY-MM-DDTHH:MM:SS.mmmZ".
+    //       Out of range values are written as 16 unquoted hex digits (the format used before ISO-8601),
+    //       and this is also accepted when reading.
     std::int64_t    datetime;
     public:
         UTCDateTime(std::int64_t datetime = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
@@ -146,6 +146,10 @@ class PutValueType
         {}
         void putValue(V const& value)
         {
+            if (serializer.outputFailed())
+            {
+                return;
+            }
             serializer.print(value);
         }
 };
@@ -161,7 +165,11 @@ class PutValueType<V, TraitType::Value>
 
         void putValue(V const& value)
         {
-            printer.addValue(value);
+            if (printer.outputFailed())
+            {
+                return;
+            }
+            printer.addMemberValue(value);
         }
 };
 
@@ -34,6 +34,7 @@
 #include "Traits.h"
 #include "ThorsIOUtil/Utility.h"
 #include "ThorsLogging/ThorsLogging.h"
+#include <exception>
 #include <iostream>
 #include <utility>
 
@@ -61,6 +62,53 @@ template<>  inline double                  scanValue<double>(char const* buffer,
 template<>  inline long double             scanValue<long double>(char const* buffer, char** end)             {return std::strtold(buffer, end);}
 
 class Serializer;
+
+/*
+ * Adds the member name (or array index) to ParserInterface::errorPath if the
+ * value being read throws. Nothing is done unless there is an error.
+ */
+class ErrorPathElement
+{
+    ParserInterface&    parser;
+    std::string const*  key;
+    std::size_t         index;
+    int                 exceptions;
+    public:
+        ErrorPathElement(ParserInterface& parser, std::string const& key)
+            : parser(parser)
+            , key(&key)
+            , index(0)
+            , exceptions(std::uncaught_exceptions())
+        {}
+        ErrorPathElement(ParserInterface& parser, std::size_t index)
+            : parser(parser)
+            , key(nullptr)
+            , index(index)
+            , exceptions(std::uncaught_exceptions())
+        {}
+        ~ErrorPathElement()
+        {
+            if (std::uncaught_exceptions() > exceptions)
+            {
+                try
+                {
+                    if (key != nullptr)
+                    {
+                        parser.addErrorPath(*key);
+                    }
+                    else
+                    {
+                        parser.addErrorPath(index);
+                    }
+                }
+                catch (...)
+                {
+                    // Must not throw while unwinding. The path is just less detailed.
+                }
+            }
+        }
+};
+
 class DeSerializer;
 
 template<TraitType type, typename T, typename I>
@@ -160,7 +208,8 @@ class Serializer
         template<typename T>
         void printObjectMembers(T const& object);
 
-        bool isRoot() const {return root;}
+        bool isRoot() const         {return root;}
+        bool outputFailed() const   {return printer.outputFailed();}
 };
 /* ------------ BaseTypeGetter Gets base type of pointer ------------------------- */
 template<typename P>
@@ -263,6 +312,7 @@ inline DeSerializer::DeSerializer(ParserInterface& parser, bool root)
 {
     if (root)
     {
+        parser.errorPath.clear();
         // Note:
         //  Note: all "root" elements are going to have a DocStart/DocEnd pair
         //  Just the outer set. So that is something that we will need to deal with
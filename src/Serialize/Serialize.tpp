@@ -188,18 +188,33 @@ class DeSerializationForBlock
         void scanObject(T& object)
         {
             std::map<std::string, bool>     memberFound;
+            Projection const*               projection = parser.projection;
             while (hasMoreValue())
             {
+                ErrorPathElement    pathElement(parser, key);
+                Projection const*   member = nullptr;
+                if (projection != nullptr)
+                {
+                    member = projection->find(key);
+                    if (member == nullptr)
+                    {
+                        // Not in the projection: the member is left untouched.
+                        parser.skipValue();
+                        continue;
+                    }
+                }
+                ProjectionScope     scope(parser, member);
                 if (!parent.scanObjectMembers(key, object))
                 {
                     parser.ignoreValue();
                 }
-                else
+                else if (parser.config.parseStrictness == ParserInterface::ParseType::Exact)
                 {
                     memberFound[key] = true;
                 }
             }
-            if (parser.config.parseStrictness == ParserInterface::ParseType::Exact)
+            // With a projection members are expected to be missing.
+            if (parser.config.parseStrictness == ParserInterface::ParseType::Exact && projection == nullptr)
             {
                 HeedAllValues<T>    check;
                 check(memberFound);
@@ -355,12 +370,20 @@ auto tryParsePolyMorphicObject(DeSerializer& parent, ParserInterface& parser, T&
                          "Invalid Object. Expecting Value");
     }
 
-    std::string className;
-    parser.getValue(className);
-
     using BaseType  = typename std::remove_pointer<T>::type;
     using AllocType = typename GetAllocationType<BaseType>::AllocType;
-    object = ConvertPointer<BaseType>::assign(PolyMorphicRegistry::getNamedTypeConvertedTo<AllocType>(className));
+    if (parser.config.polymorphicTypeId)
+    {
+        PolyMorphicTypeId   classId;
+        parser.getValue(classId);
+        object = ConvertPointer<BaseType>::assign(PolyMorphicRegistry::getTypeIdConvertedTo<AllocType>(classId));
+    }
+    else
+    {
+        std::string         className;
+        parser.getValue(className);
+        object = ConvertPointer<BaseType>::assign(PolyMorphicRegistry::getNamedTypeConvertedTo<AllocType>(className));
+    }
 
     // This uses a virtual method in the object to
     // call parsePolyMorphicObject() the difference
@@ -497,6 +520,7 @@ class DeSerializationForBlock<TraitType::Array, T>
         {
             while (hasMoreValue())
             {
+                ErrorPathElement    pathElement(parser, index);
                 parent.scanObjectMembers(index, object);
             }
         }
@@ -604,23 +628,43 @@ inline bool DeSerializer::scanObjectMembers(I const& key, T& object)
 template<typename T>
 inline void DeSerializer::parse(T& object)
 {
+    if (!root)
+    {
+        // Nested members: errors propagate to the root DeSerializer which reports them.
+        // (Catching, logging and re-throwing at every level makes bad input expensive.)
+        DeSerializationForBlock<Traits<T>::type, T>     block(*this, parser);
+        block.scanObject(object);
+        return;
+    }
     try
     {
         DeSerializationForBlock<Traits<T>::type, T>     block(*this, parser);
         block.scanObject(object);
     }
-    catch (std::exception const& e)
+    catch (ThorsAnvil::Logging::CriticalException const& e)
     {
         root = false;
         ThorsCatchMessage("ThorsAnvil::Serialize::DeSerializer", "parse", e.what());
         ThorsRethrowMessage("ThorsAnvil::Serialize::DeSerializer", "parse", e.what());
         throw;
     }
+    catch (std::exception const& e)
+    {
+        // The error path is complete now: Log where the error happened.
+        // Note: The original exception is re-thrown (callers may depend on its type).
+        //       tryImport() returns the path and offset in the ParseError.
+        root = false;
+        std::string message = parser.errorLocation(e.what());
+        ThorsCatchMessage("ThorsAnvil::Serialize::DeSerializer", "parse", message);
+        ThorsRethrowMessage("ThorsAnvil::Serialize::DeSerializer", "parse", message);
+        throw;
+    }
     catch (...)
     {
         root = false;
-        ThorsCatchMessage("ThorsAnvil::Serialize::DeSerializer", "parse", "UNKNOWN");
-        ThorsRethrowMessage("ThorsAnvil::Serialize::DeSerializer", "parse", "UNKNOWN");
+        std::string message = parser.errorLocation("UNKNOWN");
+        ThorsCatchMessage("ThorsAnvil::Serialize::DeSerializer", "parse", message);
+        ThorsRethrowMessage("ThorsAnvil::Serialize::DeSerializer", "parse", message);
         throw;
     }
 }
@@ -659,10 +703,17 @@ class SerializerForBlock
         {
             parent.printObjectMembers(object);
         }
-        void printPolyMorphicMembers(std::string const& type)
+        void printPolyMorphicMembers(char const* type)
         {
             printer.addKey(printer.config.polymorphicMarker);
-            printer.addValue(type);
+            if (printer.config.polymorphicTypeId)
+            {
+                printer.addValue(polyMorphicTypeId(type));
+            }
+            else
+            {
+                printer.addValue(std::string(type));
+            }
             printMembers();
         }
 };
@@ -682,7 +733,7 @@ class SerializerForBlock<TraitType::Value, T>
         ~SerializerForBlock()   {}
         void printMembers()
         {
-            printer.addValue(object);
+            printer.addMemberValue(object);
         }
 };
 template<typename T>
@@ -766,7 +817,7 @@ void printPolyMorphicObject(Serializer& parent, PrinterInterface& printer, T con
     SerializerForBlock<ThorsAnvil::Serialize::Traits<BaseType>::type, BaseType>  block(parent, printer, object, true);
 
     // Note the call to printPolyMorphicMembers() rather than printMembers()
-    // this adds the "__type": "<Type Name>"
+    // this adds the "__type": "<Type Name>" (or "__type": <Type Id>)
     block.printPolyMorphicMembers(T::polyMorphicSerializerName());
 }
 
@@ -832,15 +883,14 @@ class SerializerForBlock<TraitType::Enum, T>
         ~SerializerForBlock()   {}
         void printMembers()
         {
-            auto values = Traits<T>::getValues();
-            auto valueIt = values.find(object);
-            if (valueIt == values.end())
+            char const* name = Traits<T>::table.getName(object);
+            if (name == nullptr)
             {
                 ThorsLogAndThrow("ThorsAnvil::Serialize::SerializerForBlock<Enum>",
                                  "SerializerForBlock",
                                  "Invalid Enum Value");
             }
-            printer.addValue(valueIt->second);
+            printer.addValue(std::string(name));
         }
 };
 
@@ -878,9 +928,20 @@ class SerializerForBlock<TraitType::Array, T>
 template<typename T, typename M>
 SerializeMemberContainer<T, M>::SerializeMemberContainer(Serializer&, PrinterInterface& printer, T const& object, std::pair<char const*, M T::*> const& memberInfo)
 {
-    if (ThorsAnvil::Serialize::Filter<T>::filter(object, memberInfo.first))
+    if (printer.outputFailed())
     {
-        printer.addKey(ThorsAnvil::Serialize::Override<T>::nameOverride(memberInfo.first));
+        return;
+    }
+    if (!omitMember(printer, object, memberInfo.second))
+    {
+        char const*         name = ThorsAnvil::Serialize::Override<T>::nameOverride(memberInfo.first);
+        Projection const*   selected;
+        if (!Projection::select(printer.projection, name, selected))
+        {
+            return;
+        }
+        ProjectionScope     scope(printer, selected);
+        printer.addKey(name);
 
         Serializer      serialzier(printer, false);
         serialzier.print(object.*(memberInfo.second));
@@ -902,9 +963,20 @@ SerializeMemberValue<T, M, Type>::SerializeMemberValue(Serializer& parent, Print
 template<typename T, typename M, TraitType Type>
 void SerializeMemberValue<T, M, Type>::init(Serializer& parent, PrinterInterface& printer, char const* member, T const& object, M const& value)
 {
-    if (ThorsAnvil::Serialize::Filter<T>::filter(object, member))
+    if (printer.outputFailed())
     {
-        printer.addKey(ThorsAnvil::Serialize::Override<T>::nameOverride(member));
+        return;
+    }
+    if (!omitValue(printer, object, value))
+    {
+        char const*         name = ThorsAnvil::Serialize::Override<T>::nameOverride(member);
+        Projection const*   selected;
+        if (!Projection::select(printer.projection, name, selected))
+        {
+            return;
+        }
+        ProjectionScope     scope(printer, selected);
+        printer.addKey(name);
         SerializerForBlock<Type, M>  serializer(parent, printer, value);
         serializer.printMembers();
     }
@@ -934,7 +1006,8 @@ SerializeMember<T, M> make_SerializeMember(Serializer& ser, PrinterInterface& pr
 template<typename T, typename Members, std::size_t... Seq>
 inline void Serializer::printEachMember(T const& object, Members const& member, std::index_sequence<Seq...> const&)
 {
-    auto discard = {1, (make_SerializeMember(*this, printer, object, std::get<Seq>(member)),1)...};
+    // The filter is checked here as this is the only place the position of the member is known.
+    auto discard = {1, (filterMember(object, std::get<Seq>(member).first, Seq) ? (make_SerializeMember(*this, printer, object, std::get<Seq>(member)),1) : 1)...};
     (void)discard;
 }
 
@@ -10,6 +10,130 @@ using namespace ThorsAnvil::Serialize;
 
 std::string const ThorsAnvil::Serialize::defaultPolymorphicMarker = "__type"s;
 
+HEADER_ONLY_INCLUDE
+Projection::Projection()
+    : all(false)
+{}
+
+HEADER_ONLY_INCLUDE
+void Projection::add(std::string const& path)
+{
+    Projection*         node    = this;
+    std::size_t         start   = 0;
+    while (!node->all)
+    {
+        std::size_t     end     = path.find('.', start);
+        std::string     name    = path.substr(start, end - start);
+        std::unique_ptr<Projection>& child = node->members[name];
+        if (!child)
+        {
+            child = std::make_unique<Projection>();
+        }
+        node    = child.get();
+        if (end == std::string::npos)
+        {
+            // Everything below this member is selected.
+            node->all = true;
+            node->members.clear();
+            break;
+        }
+        start   = end + 1;
+    }
+}
+
+HEADER_ONLY_INCLUDE
+Projection const* Projection::find(std::string const& key) const
+{
+    auto find = members.find(key);
+    return find == members.end() ? nullptr : find->second.get();
+}
+
+HEADER_ONLY_INCLUDE
+Projection const* Projection::find(char const* key) const
+{
+    auto find = members.find(key);
+    return find == members.end() ? nullptr : find->second.get();
+}
+
+namespace
+{
+    std::shared_ptr<Projection const> buildProjection(std::initializer_list<std::string> paths)
+    {
+        std::shared_ptr<Projection>     root = std::make_shared<Projection>();
+        for (auto const& path: paths)
+        {
+            root->add(path);
+        }
+        return root;
+    }
+}
+
+HEADER_ONLY_INCLUDE
+ParserInterface::ParserConfig& ParserInterface::ParserConfig::withProjection(std::initializer_list<std::string> paths)
+{
+    projection = buildProjection(paths);
+    return *this;
+}
+
+HEADER_ONLY_INCLUDE
+PrinterInterface::PrinterConfig& PrinterInterface::PrinterConfig::withProjection(std::initializer_list<std::string> paths)
+{
+    projection = buildProjection(paths);
+    return *this;
+}
+
+HEADER_ONLY_INCLUDE
+void ParserInterface::addErrorPath(std::string const& key)
+{
+    // Json-Pointer escaping: '~' => "~0"  '/' => "~1"
+    std::string     element("/");
+    element.reserve(key.size() + 1);
+    for (char c: key)
+    {
+        switch (c)
+        {
+            case '~':   element += "~0";        break;
+            case '/':   element += "~1";        break;
+            default:    element.push_back(c);   break;
+        }
+    }
+    errorPath.insert(0, element);
+}
+
+HEADER_ONLY_INCLUDE
+std::size_t ParserInterface::errorOffset()
+{
+    // The position of the stream (ignoring its error state).
+    std::ios::iostate   state = input.rdstate();
+    input.clear();
+    std::streampos      pos = input.tellg();
+    input.clear(state);
+    return pos == std::streampos(-1) ? static_cast<std::size_t>(-1) : static_cast<std::size_t>(pos);
+}
+
+HEADER_ONLY_INCLUDE
+std::string ParserInterface::errorLocation(char const* message)
+{
+    std::string result(message);
+    result += " [Path: \"";
+    result += errorPath;
+    result += "\"";
+    std::size_t offset = errorOffset();
+    if (offset != static_cast<std::size_t>(-1))
+    {
+        result += " Offset: ";
+        result += std::to_string(offset);
+    }
+    result += "]";
+    return result;
+}
+
+HEADER_ONLY_INCLUDE
+void ParserInterface::addErrorPath(std::size_t index)
+{
+    errorPath.insert(0, "/" + std::to_string(index));
+}
+
 HEADER_ONLY_INCLUDE
 void ParserInterface::ignoreValue()
 {
@@ -23,6 +147,12 @@ void ParserInterface::ignoreValue()
     ignoreTheValue();
 }
 
+HEADER_ONLY_INCLUDE
+void ParserInterface::skipValue()
+{
+    ignoreTheValue();
+}
+
 HEADER_ONLY_INCLUDE
 void ParserInterface::ignoreTheMap()
 {
@@ -110,8 +240,8 @@ void ParserInterface::ignoreTheValue()
                              "Invalid token found: ArrayEnd");
         }
         case ParserToken::Value:     ignoreDataValue(); break;
-        case ParserToken::MapStart:  ignoreTheMap();    break;
-        case ParserToken::ArrayStart:ignoreTheArray();  break;
+        case ParserToken::MapStart:  if (!skipContainer()) {ignoreTheMap();}    break;
+        case ParserToken::ArrayStart:if (!skipContainer()) {ignoreTheArray();}  break;
         default:
         {
             ThorsLogAndThrow("ThorsAnvil::Serialize::ParserInterface",
@@ -5,10 +5,14 @@
 #include "ThorsLogging/ThorsLogging.h"
 #include <type_traits>
 #include <string>
+#include <streambuf>
 #include <iostream>
 #include <iomanip>
 #include <cstddef>
 #include <algorithm>
+#include <initializer_list>
+#include <map>
+#include <memory>
 
 namespace ThorsAnvil
 {
@@ -21,15 +25,18 @@ struct EscapeString
     EscapeString(std::string const& value)
         : value(value)
     {}
+    static bool isEscape(char c)
+    {
+        return (c >= 0x00 && c <= 0x1f) || c == '"' || c == '\\';
+    }
+    static bool needsEscape(std::string const& value)
+    {
+        return std::find_if(std::begin(value), std::end(value), isEscape) != std::end(value);
+    }
     friend std::ostream& operator<<(std::ostream& stream, EscapeString const& data)
     {
         std::string const& value = data.value;
 
-        static auto isEscape = [](char c)
-        {
-            return (c >= 0x00 && c <= 0x1f) || c == '"' || c == '\\';
-        };
-
         auto begin  = std::begin(value);
         auto end    = std::end(value);
         auto next = std::find_if(begin, end, isEscape);
@@ -41,7 +48,7 @@ struct EscapeString
         {
             while (next != end)
             {
-                stream << std::string(begin, next);
+                stream.write(value.data() + (begin - std::begin(value)), next - begin);
                 if (*next == '"')
                 {
                     stream << R"(\")";
@@ -98,12 +105,144 @@ struct EscapeString
                 begin = next;
                 next = std::find_if(begin, end, isEscape);
             }
-            stream << std::string(begin, end);
+            stream.write(value.data() + (begin - std::begin(value)), end - begin);
         }
         return stream;
     }
 };
 
+/*
+ * A stream buffer that appends everything written to it onto the end of a std::string.
+ * Used when the serialized result is needed in a string; unlike std::stringstream
+ * there is no internal buffer that has to be copied out with str().
+ */
+class StringOutputBuffer: public std::streambuf
+{
+    std::string&    output;
+    public:
+        StringOutputBuffer(std::string& output)
+            : output(output)
+        {}
+    protected:
+        virtual int_type overflow(int_type c) override
+        {
+            if (!traits_type::eq_int_type(c, traits_type::eof()))
+            {
+                output.push_back(traits_type::to_char_type(c));
+            }
+            return traits_type::not_eof(c);
+        }
+        virtual std::streamsize xsputn(char_type const* s, std::streamsize n) override
+        {
+            output.append(s, n);
+            return n;
+        }
+};
+
+/*
+ * A stream buffer that discards everything written to it but counts the bytes.
+ * Used for a sizing pass: serialize once to find the exact size of the output
+ * (escaping, number formatting and white space included) then allocate once.
+ */
+class SizeOutputBuffer: public std::streambuf
+{
+    std::size_t     count;
+    public:
+        SizeOutputBuffer()
+            : count(0)
+        {}
+        std::size_t size() const    {return count;}
+    protected:
+        virtual int_type overflow(int_type c) override
+        {
+            if (!traits_type::eq_int_type(c, traits_type::eof()))
+            {
+                ++count;
+            }
+            return traits_type::not_eof(c);
+        }
+        virtual std::streamsize xsputn(char_type const* /*s*/, std::streamsize n) override
+        {
+            count += n;
+            return n;
+        }
+};
+
+/*
+ * A read only stream buffer over a range of memory that is owned by somebody else.
+ * Used to parse part of a large buffer (e.g. one chunk of a file) without copying it.
+ */
+class MemoryInputBuffer: public std::streambuf
+{
+    public:
+        MemoryInputBuffer(char const* begin = nullptr, char const* end = nullptr)
+        {
+            reset(begin, end);
+        }
+        // Re-use the buffer for a different range.
+        void reset(char const* begin, char const* end)
+        {
+            char* start = const_cast<char*>(begin);
+            setg(start, start, start + (end - begin));
+        }
+        // Direct access to the unread part of the buffer (see JsonManualLexer::skipContainer()).
+        char const* current() const             {return gptr();}
+        char const* last() const                {return egptr();}
+        void        consume(std::size_t count)  {setg(eback(), gptr() + count, egptr());}
+    protected:
+        // Only reports the current position (so tellg() works).
+        virtual pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override
+        {
+            if (off != 0 || dir != std::ios_base::cur || !(which & std::ios_base::in))
+            {
+                return pos_type(off_type(-1));
+            }
+            return pos_type(gptr() - eback());
+        }
+};
+
+/*
+ * A stream buffer over a fixed size block of memory owned by the caller.
+ * Nothing is allocated. When the block is full the stream fails (badbit)
+ * and full() is true; the serializer then stops (see PrinterInterface::outputFailed()).
+ */
+class FixedOutputBuffer: public std::streambuf
+{
+    bool    overflowed;
+    public:
+        FixedOutputBuffer(char* begin = nullptr, char* end = nullptr)
+        {
+            reset(begin, end);
+        }
+        // Re-use the buffer for a different block of memory.
+        void reset(char* begin, char* end)
+        {
+            setp(begin, end);
+            overflowed = false;
+        }
+        std::size_t size() const    {return pptr() - pbase();}
+        bool        full() const    {return overflowed;}
+    protected:
+        virtual int_type overflow(int_type /*c*/) override
+        {
+            overflowed = true;
+            return traits_type::eof();
+        }
+};
+
+/*
+ * A stream buffer that can keep a reference to data rather than copy it.
+ * Printers pass large strings and binary payloads that belong to the object being
+ * serialized to PrinterInterface::writeStable(), which uses addReference() when the
+ * stream is using one of these buffers (see IOVecOutputBuffer.h).
+ * The data must stay valid (and unchanged) until the buffer has been flushed.
+ */
+class ReferenceOutputBuffer: public std::streambuf
+{
+    public:
+        virtual void addReference(char const* data, std::size_t size) = 0;
+};
+
 extern std::string const defaultPolymorphicMarker;
 
 /*
@@ -148,11 +287,45 @@ struct GetPrimaryParentType<Parents<Args...>>
     using type = typename std::tuple_element<0, std::tuple<Args...>>::type;
 };
 
+/*
+ * The set of member paths to read from / write to a document
+ * (see ParserConfig::withProjection() and PrinterConfig::withProjection()).
+ * A path is a list of member names separated by '.' e.g. "user.id".
+ * Arrays are transparent: "statuses.id" selects "id" in each element of the "statuses" array.
+ * Naming a member selects everything below it.
+ */
+class Projection
+{
+    std::map<std::string, std::unique_ptr<Projection>, std::less<>>  members;
+    bool                                                            all;
+    public:
+        Projection();
+        void    add(std::string const& path);
+        // The projection for the member called key (nullptr if the member is not selected).
+        Projection const*   find(std::string const& key) const;
+        Projection const*   find(char const* key) const;
+        bool                selectsAll() const  {return all;}
+
+        // Is the member called name of an object with this projection selected (nullptr: all members are)?
+        // If it is member is set to the projection for the member's value.
+        static bool select(Projection const* projection, char const* name, Projection const*& member)
+        {
+            if (projection == nullptr)
+            {
+                member = nullptr;
+                return true;
+            }
+            member = projection->find(name);
+            return member != nullptr;
+        }
+};
+
 class ParserInterface
 {
     public:
         enum class ParseType   {Weak, Strict, Exact};
         enum class ParserToken {Error, DocStart, DocEnd, MapStart, MapEnd, ArrayStart, ArrayEnd, Key, Value};
+        enum class ValueKind   {Null, Bool, Integer, Float, String, Other};
         struct ParserConfig
         {
             ParserConfig(ParseType parseStrictness = ParseType::Weak,
@@ -162,39 +335,67 @@ class ParserInterface
                 , polymorphicMarker(polymorphicMarker)
                 , catchExceptions(catchExceptions)
                 , parserInfo(0)
+                , trustedInput(false)
+                , polymorphicTypeId(false)
             {}
             ParserConfig(std::string const& polymorphicMarker, bool catchExceptions = true)
                 : parseStrictness(ParseType::Weak)
                 , polymorphicMarker(polymorphicMarker)
                 , catchExceptions(catchExceptions)
                 , parserInfo(0)
+                , trustedInput(false)
+                , polymorphicTypeId(false)
             {}
             ParserConfig(bool catchExceptions)
                 : parseStrictness(ParseType::Weak)
                 , polymorphicMarker(defaultPolymorphicMarker)
                 , catchExceptions(catchExceptions)
                 , parserInfo(0)
+                , trustedInput(false)
+                , polymorphicTypeId(false)
             {}
             ParserConfig(ParseType parseStrictness, bool catchExceptions)
                 : parseStrictness(parseStrictness)
                 , polymorphicMarker(defaultPolymorphicMarker)
                 , catchExceptions(catchExceptions)
                 , parserInfo(0)
+                , trustedInput(false)
+                , polymorphicTypeId(false)
             {}
             ParseType       parseStrictness;
             std::string     polymorphicMarker;
             bool            catchExceptions;
             long            parserInfo;
+            // The input was produced by this library's printers (e.g. traffic between our own services).
+            // The Json parser skips its syntax validation (the token sequence is assumed valid) and
+            // reads strings with a faster path. Bad input gives undefined results (debug builds assert).
+            bool            trustedInput;
+            // The polymorphic type is read as a PolyMorphicTypeId (an integer) rather than the class name.
+            // Must match the PrinterConfig used to write the data.
+            bool            polymorphicTypeId;
+            // Only members on these paths are read. All other members are left untouched and
+            // their value is skipped (whatever the parseStrictness). Empty: read everything.
+            //      jsonImporter(tweet, config.withProjection({"user.id", "created_at", "entities.hashtags"}))
+            std::shared_ptr<Projection const>   projection;
+
+            ParserConfig& withProjection(std::initializer_list<std::string> paths);
         };
 
         std::istream&   input;
         ParserToken     pushBack;
         ParserConfig    config;
+        // Json-Pointer (RFC 6901) to the value being read when an error was thrown (e.g. "/statuses/3/user/id").
+        // Built while the exception unwinds (see ErrorPathElement in Serialize.h) so costs nothing on success.
+        std::string     errorPath;
+        // The projection for the object being read (nullptr read all members).
+        // Moved up and down the config.projection tree by ProjectionScope (below).
+        Projection const* projection;
 
         ParserInterface(std::istream& input, ParserConfig  config = ParserConfig{})
             : input(input)
             , pushBack(ParserToken::Error)
             , config(config)
+            , projection(this->config.projection.get())
         {}
         virtual ~ParserInterface() {}
         virtual FormatType formatType()                 = 0;
@@ -204,6 +405,23 @@ class ParserInterface
         virtual std::string     getKey()                = 0;
 
         virtual void    ignoreDataValue()                {}
+        // Called when the MapStart/ArrayStart of an ignored value has been read.
+        // A parser that can find the end of the container without producing tokens
+        // consumes it (including the closing token) and returns true.
+        virtual bool    skipContainer()                  {return false;}
+        // After an exception: true if it was caused by badly formed input
+        // (rather than well formed input that does not match the object being read).
+        virtual bool    syntaxError() const              {return false;}
+        // After an exception: The byte offset in the input where the error was found.
+        // This is the position of the stream (tellg()) not a count kept by the lexer
+        // (std::size_t(-1) if the stream can not report its position).
+        virtual std::size_t errorOffset();
+        // message with the errorPath and errorOffset() appended.
+                std::string errorLocation(char const* message);
+
+        // Prefix errorPath with a member name / array index.
+                void    addErrorPath(std::string const& key);
+                void    addErrorPath(std::size_t index);
 
         virtual void    getValue(short int&)             = 0;
         virtual void    getValue(int&)                   = 0;
@@ -224,10 +442,15 @@ class ParserInterface
         virtual void    getValue(std::string&)           = 0;
 
         virtual bool    isValueNull()                    = 0;
+        // The kind of the current Value token.
+        // Allows a value to be read without knowing the C++ type it will be stored in.
+        virtual ValueKind getValueKind()                 {return ValueKind::Other;}
 
         virtual std::string getRawValue()                = 0;
 
         void    ignoreValue();
+        // Ignore the next value whatever the parseStrictness (used for members outside the projection).
+        void    skipValue();
 
         std::istream& stream() {return input;}
     private:
@@ -250,6 +473,8 @@ class PrinterInterface
                 , polymorphicMarker(polymorphicMarker)
                 , catchExceptions(catchExceptions)
                 , parserInfo(0)
+                , omitDefaults(false)
+                , polymorphicTypeId(false)
             {}
             PrinterConfig(std::string const& polymorphicMarker,
                           bool catchExceptions = true)
@@ -257,34 +482,58 @@ class PrinterInterface
                 , polymorphicMarker(polymorphicMarker)
                 , catchExceptions(catchExceptions)
                 , parserInfo(0)
+                , omitDefaults(false)
+                , polymorphicTypeId(false)
             {}
             PrinterConfig(bool catchExceptions)
                 : characteristics(OutputType::Default)
                 , polymorphicMarker(defaultPolymorphicMarker)
                 , catchExceptions(catchExceptions)
                 , parserInfo(0)
+                , omitDefaults(false)
+                , polymorphicTypeId(false)
             {}
             PrinterConfig(OutputType characteristic, bool catchExceptions)
                 : characteristics(characteristic)
                 , polymorphicMarker(defaultPolymorphicMarker)
                 , catchExceptions(catchExceptions)
                 , parserInfo(0)
+                , omitDefaults(false)
+                , polymorphicTypeId(false)
             {}
             OutputType      characteristics;
             std::string     polymorphicMarker;
             bool            catchExceptions;
             long            parserInfo;
+            // Only members on these paths are written (e.g. from a "?fields=" request parameter).
+            // Paths use the member names as they appear in the output. Empty: write everything.
+            //      jsonExporter(tweet, config.withProjection({"user.id", "created_at"}))
+            std::shared_ptr<Projection const>   projection;
+            // Members that have their default value (0, false, "", empty container, null pointer)
+            // are not written. See ThorsAnvil_MakeOmitDefaults() to set this per type.
+            bool            omitDefaults;
+            // The polymorphic type is written as a PolyMorphicTypeId (a 31 bit hash of the class name)
+            // rather than the class name. Useful for binary formats (Bson) where it saves the string.
+            bool            polymorphicTypeId;
+
+            PrinterConfig& withProjection(std::initializer_list<std::string> paths);
         };
         // Default:     What ever the implementation likes.
         // Stream:      Compressed for over the wire protocol.
         // Config:      Human readable (potentially config file like)
 
-        std::ostream&   output;
-        PrinterConfig   config;
+        std::ostream&           output;
+        PrinterConfig           config;
+        ReferenceOutputBuffer*  referenceOutput;
+        // The projection for the object being written (nullptr write all members).
+        // Moved up and down the config.projection tree by ProjectionScope (below).
+        Projection const*       projection;
 
         PrinterInterface(std::ostream& output, PrinterConfig config = PrinterConfig{})
             : output(output)
             , config(config)
+            , referenceOutput(dynamic_cast<ReferenceOutputBuffer*>(output.rdbuf()))
+            , projection(this->config.projection.get())
         {}
         virtual ~PrinterInterface() {}
         virtual FormatType formatType()                 = 0;
@@ -319,6 +568,15 @@ class PrinterInterface
 
         virtual void    addNull()                       = 0;
 
+        // A string that is part of the object being serialized (so lives until the export is complete).
+        // Printers may reference it rather than copy it (see writeStable()).
+        virtual void    addStableValue(std::string const& value)    {addValue(value);}
+
+        // Used by the Serializer for members and container elements.
+        template<typename T>
+        void    addMemberValue(T const& value)              {addValue(value);}
+        void    addMemberValue(std::string const& value)    {addStableValue(value);}
+
         void addValue(void*)        = delete;
         void addValue(void const*)  = delete;
 
@@ -342,6 +600,46 @@ class PrinterInterface
         virtual std::size_t getSizeRaw(std::size_t)                 {return 0;}
 
         std::ostream& stream() {return output;}
+
+        // The output stream has failed (e.g. a fixed size buffer is full).
+        // The Serializer stops visiting members and elements as nothing more can be written.
+        bool outputFailed() const   {return output.fail();}
+
+        // Write data that belongs to the object being serialized.
+        // It is not copied if the stream buffer can reference it (see ReferenceOutputBuffer).
+        void writeStable(char const* data, std::size_t size)
+        {
+            if (referenceOutput != nullptr && output)
+            {
+                referenceOutput->addReference(data, size);
+            }
+            else
+            {
+                output.write(data, size);
+            }
+        }
+};
+
+/*
+ * Moves the projection of a ParserInterface/PrinterInterface to the projection of
+ * the member being read/written and restores it when the member is done.
+ */
+template<typename Interface>
+class ProjectionScope
+{
+    Interface&          target;
+    Projection const*   saved;
+    public:
+        ProjectionScope(Interface& target, Projection const* member)
+            : target(target)
+            , saved(target.projection)
+        {
+            target.projection = (member == nullptr || member->selectsAll()) ? nullptr : member;
+        }
+        ~ProjectionScope()
+        {
+            target.projection = saved;
+        }
 };
 
 template<typename T, bool = HasParent<T>::value>
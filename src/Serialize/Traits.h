@@ -24,6 +24,11 @@
  *
  *      ThorsAnvil_MakeFilter(DataType, filter)
  *      ThorsAnvil_Template_MakeFilter(Count, DataType, filter)
+ *      ThorsAnvil_MakeFilterMask(DataType, mask)
+ *      ThorsAnvil_Template_MakeFilterMask(Count, DataType, mask)
+ *
+ *      ThorsAnvil_MakeOmitDefaults(DataType, omit)
+ *      ThorsAnvil_Template_MakeOmitDefaults(Count, DataType, omit)
  *
  * --------------------------------------------------------------------------
  *
@@ -59,6 +64,8 @@
  *
  *              ThorsAnvil_MakeEnum(Enum-Type, Enum-1, Enum-2 etc)
  *
+ *              The name <=> value tables are built at compile time (see EnumTable).
+ *
  *      If you want pointers to handle polymorphic pointers
  *      Then we need some extra information:
  *
@@ -106,6 +113,23 @@
  *                                      From: The C++ identifier.
  *                                      To:   The Key used in the JSON/BSON/YAML file.
  *
+ * Members can be left out of the output on a per object basis with a filter.
+ *
+ *      ThorsAnvil_MakeFilter(DataType, filter)
+ *          filter is a std::map<std::string, bool> member of DataType (member name => print it).
+ *      ThorsAnvil_MakeFilterMask(DataType, mask)
+ *          mask is a ThorsAnvil::Serialize::FilterMask member of DataType (a single 64 bit word).
+ *          Members are identified by their position in ThorsAnvil_MakeTrait():
+ *              object.mask.exclude(ThorsAnvil::Serialize::Traits<DataType>::MemberIndex::name);
+ *          Checking a member is a bit test (rather than a map lookup).
+ *
+ * Members that hold their default value (0, false, empty string/container, null pointer)
+ * are not written when PrinterConfig::omitDefaults is set. This can be forced on (true)
+ * or off (false) for the members of a specific type whatever the config:
+ *
+ *      ThorsAnvil_MakeOmitDefaults(DataType, omit)
+ *      ThorsAnvil_Template_MakeOmitDefaults(Count, DataType, omit)
+ *
  * --------------------------------------------------------------------------
  *
  *      Examples:
@@ -262,14 +286,20 @@
 #include "ThorsIOUtil/Utility.h"
 #include "ThorsLogging/ThorsLogging.h"
 #include <string>
+#include <string_view>
 #include <tuple>
 #include <map>
 #include <functional>
 #include <memory>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <algorithm>
 #include <utility>
 #include <type_traits>
 #include <stdexcept>
 #include <cstddef>
+#include <cstdint>
 #include <cstring>
 #include <numeric>
 
@@ -414,9 +444,15 @@
 #define THOR_TYPEACTION(TC, Type, Member)       std::pair<char const*, decltype(&Type BUILDTEMPLATETYPEVALUE(THOR_TYPENAMEVALUEACTION, TC) ::Member)>
 #define THOR_VALUEACTION(TC, Type, Member)      { QUOTE(Member), &Type BUILDTEMPLATETYPEVALUE(THOR_TYPENAMEVALUEACTION, TC) ::Member }
 #define THOR_NAMEACTION(TC, Type, Member)       { Type::Member, #Member ## s}
+#define THOR_ENUMVALUEACTION(TC, Type, Member)  Type::Member
+#define THOR_ENUMNAMEACTION(TC, Type, Member)   #Member
 #define LAST_THOR_TYPEACTION(TC, Type)
 #define LAST_THOR_VALUEACTION(TC, Type)
 #define LAST_THOR_NAMEACTION(TC, Type)
+#define LAST_THOR_ENUMVALUEACTION(TC, Type)
+#define LAST_THOR_ENUMNAMEACTION(TC, Type)
+#define THOR_INDEXACTION(TC, Type, Member)      Member
+#define LAST_THOR_INDEXACTION(TC, Type)         ThorsAnvil_NoMembers
 
 #define THOR_TYPENAMEPARAMACTION(Ex, Id)        typename T ## Id
 #define THOR_TYPENAMEVALUEACTION(Ex, Id)        T ## Id
@@ -519,6 +555,45 @@ class Filter<DataType BUILDTEMPLATETYPEVALUE(THOR_TYPENAMEVALUEACTION, Count) >
 static_assert(true, "")
 
 
+#define ThorsAnvil_MakeFilterMask(DataType, member)                     \
+    ThorsAnvil_MakeFilterMask_Base(00,    DataType, member)
+#define ThorsAnvil_Template_MakeFilterMask(Count, DataType, member)     \
+    ThorsAnvil_MakeFilterMask_Base(Count, DataType, member)
+
+
+#define ThorsAnvil_MakeFilterMask_Base(Count, DataType, member)         \
+namespace ThorsAnvil { namespace Serialize {                            \
+template<BUILDTEMPLATETYPEPARAM(THOR_TYPENAMEPARAMACTION, Count)>       \
+class Filter<DataType BUILDTEMPLATETYPEVALUE(THOR_TYPENAMEVALUEACTION, Count) > \
+{                                                                       \
+    public:                                                             \
+        static bool filter(DataType BUILDTEMPLATETYPEVALUE(THOR_TYPENAMEVALUEACTION, Count) const& object, std::size_t index)    \
+        {                                                               \
+            return !object.member.excluded(index);                      \
+        }                                                               \
+};                                                                      \
+}}                                                                      \
+static_assert(true, "")
+
+
+#define ThorsAnvil_MakeOmitDefaults(DataType, value)                    \
+    ThorsAnvil_MakeOmitDefaults_Base(00,    DataType, value)
+#define ThorsAnvil_Template_MakeOmitDefaults(Count, DataType, value)    \
+    ThorsAnvil_MakeOmitDefaults_Base(Count, DataType, value)
+
+
+#define ThorsAnvil_MakeOmitDefaults_Base(Count, DataType, value)        \
+namespace ThorsAnvil { namespace Serialize {                            \
+template<BUILDTEMPLATETYPEPARAM(THOR_TYPENAMEPARAMACTION, Count)>       \
+class OmitDefaults<DataType BUILDTEMPLATETYPEVALUE(THOR_TYPENAMEVALUEACTION, Count) > \
+{                                                                       \
+    public:                                                             \
+        static constexpr bool omit(PrinterInterface const& /*printer*/) {return value;} \
+};                                                                      \
+}}                                                                      \
+static_assert(true, "")
+
+
 #define ThorsAnvil_MakeTrait_Base(ParentType, TType, Count, DataType, ...)  \
 namespace ThorsAnvil { namespace Serialize {                            \
 template<BUILDTEMPLATETYPEPARAM(THOR_TYPENAMEPARAMACTION, Count)>       \
@@ -532,6 +607,13 @@ class Traits<DataType BUILDTEMPLATETYPEVALUE(THOR_TYPENAMEVALUEACTION, Count) >
         using Members = std::tuple<                                     \
                         REP_N(THOR_TYPEACTION, Count, DataType, __VA_ARGS__)        \
                                     >;                                  \
+        /* Position of each member in Members (see FilterMask) */       \
+        struct MemberIndex                                              \
+        {                                                               \
+            enum : std::size_t {                                        \
+                        REP_N(THOR_INDEXACTION, Count, DataType, __VA_ARGS__)       \
+                                };                                      \
+        };                                                              \
                                                                         \
         static Members const& getMembers()                              \
         {                                                               \
@@ -560,13 +642,22 @@ class Traits<DataType BUILDTEMPLATETYPEVALUE(THOR_TYPENAMEVALUEACTION, Count) >
         }                                                               \
                                                                         \
         template<typename M>                                            \
-        static std::pair<std::size_t, std::size_t> addSizeEachMemberItem(PrinterInterface& printer, MyType const& object, M item) \
+        static std::pair<std::size_t, std::size_t> addSizeEachMemberItem(PrinterInterface& printer, MyType const& object, M item, std::size_t index) \
         {                                                               \
-            if (!Filter<MyType>::filter(object, item.first)) {          \
+            if (!filterMember(object, item.first, index)) {             \
+                return std::make_pair(0UL,0UL);                         \
+            }                                                           \
+            if (omitMember(printer, object, item.second)) {             \
                 return std::make_pair(0UL,0UL);                         \
             }                                                           \
+            char const*         name = Override<MyType>::nameOverride(item.first);      \
+            Projection const*   selected;                               \
+            if (!Projection::select(printer.projection, name, selected)) {              \
+                return std::make_pair(0UL,0UL);                         \
+            }                                                           \
+            ProjectionScope     scope(printer, selected);               \
             auto partSize   = addSizeOneMember(printer, object, item.second);           \
-            auto nameSize   = std::strlen(Override<MyType>::nameOverride(item.first));  \
+            auto nameSize   = std::strlen(name);                        \
             return std::make_pair(partSize + nameSize, 1);              \
         }                                                               \
         template<std::size_t... Seq>                                    \
@@ -575,7 +666,7 @@ class Traits<DataType BUILDTEMPLATETYPEVALUE(THOR_TYPENAMEVALUEACTION, Count) >
             Members const& members = getMembers();                      \
             std::initializer_list<std::pair<std::size_t, std::size_t>>  sizeData = {    \
                 std::make_pair(std::size_t{0}, std::size_t{0}),                         \
-                addSizeEachMemberItem(printer, object, std::get<Seq>(members))...       \
+                addSizeEachMemberItem(printer, object, std::get<Seq>(members), Seq)...  \
             };                                                          \
             return std::accumulate(std::begin(sizeData), std::end(sizeData), std::make_pair(0UL, 0UL),                                  \
                                    [](auto lhs, auto rhs){return std::make_pair(lhs.first + rhs.first, lhs.second + rhs.second);});     \
@@ -698,36 +789,53 @@ class Traits<EnumName>                                                  \
 {                                                                       \
     public:                                                             \
         static constexpr    TraitType       type = TraitType::Enum;     \
+        static constexpr    EnumTable<EnumName, NUM_ARGS(__VA_ARGS__, 1)> table =  \
+        {                                                               \
+            {REP_N(THOR_ENUMVALUEACTION, 0, EnumName, __VA_ARGS__, 1)},  \
+            {REP_N(THOR_ENUMNAMEACTION, 0, EnumName, __VA_ARGS__, 1)}    \
+        };                                                              \
         static std::map<EnumName, std::string> const& getValues()       \
         {                                                               \
-            using std::string_literals::operator""s;                    \
-            static const std::map<EnumName, std::string> values =       \
+            static const std::map<EnumName, std::string> values = []()  \
             {                                                           \
-                REP_N(THOR_NAMEACTION, 0, EnumName, __VA_ARGS__, 1)     \
-            };                                                          \
+                std::map<EnumName, std::string> result;                 \
+                for (std::size_t loop = 0; loop < table.size(); ++loop) \
+                {                                                       \
+                    result.emplace(table.value(loop), table.name(loop));\
+                }                                                       \
+                return result;                                          \
+            }();                                                        \
             return values;                                              \
         }                                                               \
         static std::size_t getSize()                                    \
         {                                                               \
-            return NUM_ARGS(__VA_ARGS__, 1);                            \
+            return table.size();                                        \
+        }                                                               \
+        static char const* getName(EnumName const& value)               \
+        {                                                               \
+            char const* name = table.getName(value);                    \
+            if (name == nullptr)                                        \
+            {                                                           \
+                ThorsLogAndThrow("ThorsAnvil::Serialize::Traits<EnumName>", \
+                                 "getName",                             \
+                                 "Invalid Enum Value");                 \
+            }                                                           \
+            return name;                                                \
         }                                                               \
         static EnumName getValue(std::string const& val, std::string const&) \
         {                                                               \
-            std::map<EnumName, std::string> const& values = getValues();\
-            for (auto const& value: values)                             \
+            EnumName    result{};                                       \
+            if (!table.getValue(val.data(), val.size(), result))        \
             {                                                           \
-                if (val == value.second) {                              \
-                    return value.first;                                 \
-                }                                                       \
+                ThorsLogAndThrow("ThorsAnvil::Serialize::Traits<EnumName>", \
+                                 "getValue",                            \
+                                 "Invalid Enum Value");                 \
             }                                                           \
-            ThorsLogAndThrow("ThorsAnvil::Serialize::Traits<EnumName>", \
-                             "getValue",                                \
-                             "Invalid Enum Value");                     \
+            return result;                                              \
         }                                                               \
         static std::size_t getPrintSize(PrinterInterface& printer, EnumName const& value, bool)\
         {                                                               \
-            auto find = getValues().find(value);                        \
-            return printer.getSizeValue(find->second);                  \
+            return printer.getSizeValue(std::string(getName(value)));   \
         }                                                               \
 };                                                                      \
 }}                                                                      \
@@ -792,7 +900,15 @@ static_assert(true)
     virtual std::size_t getPolyMorphicPrintSize(ThorsAnvil::Serialize::PrinterInterface& printer) const \
     {                                                                                       \
         std::size_t count = 1;                                                              \
-        std::size_t memberSize = (printer.config.polymorphicMarker.size() + printer.getSizeValue(std::string(polyMorphicSerializerName())));\
+        std::size_t memberSize = printer.config.polymorphicMarker.size();                  \
+        if (printer.config.polymorphicTypeId)                                               \
+        {                                                                                   \
+            memberSize += printer.getSizeValue(ThorsAnvil::Serialize::polyMorphicTypeId(polyMorphicSerializerName()));\
+        }                                                                                   \
+        else                                                                                \
+        {                                                                                   \
+            memberSize += printer.getSizeValue(std::string(polyMorphicSerializerName()));  \
+        }                                                                                   \
                                                                                             \
         return getNormalPrintSize(printer, *this, count, memberSize);                       \
     }                                                                                       \
@@ -849,6 +965,303 @@ class Filter
         static constexpr bool filter(T const& /*object*/, char const* /*name*/)   {return true;}
 };
 
+/*
+ * The per object filter used by ThorsAnvil_MakeFilterMask().
+ * Bit N set: the member at position N in ThorsAnvil_MakeTrait() is not serialized.
+ * The macros support at most 43 members so one 64 bit word is enough.
+ */
+class FilterMask
+{
+    std::uint64_t   excludedMembers;
+    public:
+        FilterMask()
+            : excludedMembers(0)
+        {}
+        void exclude(std::size_t index)         {excludedMembers |= (std::uint64_t{1} << index);}
+        void include(std::size_t index)         {excludedMembers &= ~(std::uint64_t{1} << index);}
+        bool excluded(std::size_t index) const  {return (excludedMembers & (std::uint64_t{1} << index)) != 0;}
+};
+
+/*
+ * Apply Filter<T> to the member at position index.
+ * A Filter built with ThorsAnvil_MakeFilterMask() uses the index,
+ * otherwise (ThorsAnvil_MakeFilter() or the default) the name.
+ */
+template<typename T>
+auto filterMember(T const& object, char const* /*name*/, std::size_t index, int) -> decltype(Filter<T>::filter(object, index), bool())
+{
+    return Filter<T>::filter(object, index);
+}
+template<typename T>
+bool filterMember(T const& object, char const* name, std::size_t /*index*/, long)
+{
+    return Filter<T>::filter(object, name);
+}
+template<typename T>
+bool filterMember(T const& object, char const* name, std::size_t index)
+{
+    return filterMember(object, name, index, 0);
+}
+
+/*
+ * Should members of T that have their default value be left out of the output?
+ * See ThorsAnvil_MakeOmitDefaults()
+ */
+template<typename T>
+class OmitDefaults
+{
+    public:
+        static bool omit(PrinterInterface const& printer)   {return printer.config.omitDefaults;}
+};
+
+/*
+ * Does a member have its default value?
+ *      Numbers/bool:           0/false
+ *      Pointers:               nullptr (raw and smart pointers)
+ *      Strings/Containers:     empty()
+ *      std::optional:          !has_value()
+ * Anything else (objects, enums) is always written.
+ */
+template<int N>
+struct DefaultValueRank: DefaultValueRank<N - 1> {};
+template<>
+struct DefaultValueRank<0> {};
+
+template<typename M>
+auto isDefaultValue(M const& value, DefaultValueRank<4> const&) -> std::enable_if_t<std::is_arithmetic<M>::value || std::is_pointer<M>::value, bool>
+{
+    return value == M{};
+}
+template<typename M>
+auto isDefaultValue(M const& value, DefaultValueRank<3> const&) -> decltype(value.empty(), bool())
+{
+    return value.empty();
+}
+template<typename M>
+auto isDefaultValue(M const& value, DefaultValueRank<2> const&) -> decltype(value.has_value(), bool())
+{
+    return !value.has_value();
+}
+template<typename M>
+auto isDefaultValue(M const& value, DefaultValueRank<1> const&) -> decltype(value == nullptr, bool())
+{
+    return value == nullptr;
+}
+template<typename M>
+bool isDefaultValue(M const& /*value*/, DefaultValueRank<0> const&)
+{
+    return false;
+}
+template<typename M>
+bool isDefaultValue(M const& value)
+{
+    return isDefaultValue(value, DefaultValueRank<4>{});
+}
+
+// Used by the Serializer (and the Bson size calculation) to decide if a member is left out.
+template<typename T, typename M>
+bool omitValue(PrinterInterface const& printer, T const& /*object*/, M const& value)
+{
+    return OmitDefaults<T>::omit(printer) && isDefaultValue(value);
+}
+template<typename T, typename M>
+bool omitMember(PrinterInterface const& printer, T const& object, M T::* member)
+{
+    return omitValue(printer, object, object.*member);
+}
+template<typename T, typename M>
+bool omitMember(PrinterInterface const& printer, T const& object, M* member)
+{
+    return member != nullptr && omitValue(printer, object, *member);
+}
+
+/*
+ * The lookup tables used by ThorsAnvil_MakeEnum().
+ * They are built by the compiler so there is no static initialization.
+ *
+ *      enum => name:   The entries are sorted by value. If the values have no gaps
+ *                      the entry is indexed directly (value - first value)
+ *                      otherwise a binary search is used.
+ *      name => enum:   A hash table with at least 4 slots per name.
+ *                      The constructor searches for a hash seed that gives no collisions
+ *                      (a perfect hash) so a lookup is one hash and one string compare.
+ *                      If no seed is found it falls back to linear probing.
+ */
+constexpr std::size_t enumHashSize(std::size_t count)
+{
+    std::size_t result = 1;
+    while (result < count * 4)
+    {
+        result *= 2;
+    }
+    return result;
+}
+
+template<typename E, std::size_t N>
+class EnumTable
+{
+    using Underlying = std::underlying_type_t<E>;
+    static constexpr std::size_t    hashSize    = enumHashSize(N);
+    static constexpr std::size_t    hashMask    = hashSize - 1;
+    static constexpr std::uint8_t   emptySlot   = 0xFF;
+    static constexpr std::uint32_t  maxSeed     = 1024;
+    static_assert(N < emptySlot, "EnumTable: Too many values");
+
+    E               values[N]       = {};
+    char const*     names[N]        = {};
+    std::size_t     sizes[N]        = {};
+    std::uint8_t    slots[hashSize] = {};
+    std::uint32_t   seed            = 0;
+    bool            dense           = true;
+
+    static constexpr Underlying toUnderlying(E value)
+    {
+        return static_cast<Underlying>(value);
+    }
+    static constexpr std::size_t length(char const* name)
+    {
+        std::size_t result = 0;
+        while (name[result] != '\0')
+        {
+            ++result;
+        }
+        return result;
+    }
+    // FNV-1a with the seed mixed into the offset basis.
+    static constexpr std::uint32_t hash(std::uint32_t seed, char const* name, std::size_t size)
+    {
+        std::uint32_t result = 2166136261u ^ (seed * 0x9E3779B9u);
+        for (std::size_t loop = 0; loop < size; ++loop)
+        {
+            result ^= static_cast<unsigned char>(name[loop]);
+            result *= 16777619u;
+        }
+        return result ^ (result >> 16);
+    }
+    static constexpr bool equal(char const* lhs, char const* rhs, std::size_t size)
+    {
+        for (std::size_t loop = 0; loop < size; ++loop)
+        {
+            if (lhs[loop] != rhs[loop])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+    // Returns false if there was a collision (when probe is false the table is left incomplete).
+    constexpr bool buildHash(bool probe)
+    {
+        for (std::size_t loop = 0; loop < hashSize; ++loop)
+        {
+            slots[loop] = emptySlot;
+        }
+        bool perfect = true;
+        for (std::size_t loop = 0; loop < N; ++loop)
+        {
+            std::size_t slot = hash(seed, names[loop], sizes[loop]) & hashMask;
+            while (slots[slot] != emptySlot)
+            {
+                perfect = false;
+                if (!probe)
+                {
+                    return false;
+                }
+                slot = (slot + 1) & hashMask;
+            }
+            slots[slot] = static_cast<std::uint8_t>(loop);
+        }
+        return perfect;
+    }
+    constexpr std::size_t findValue(E value) const
+    {
+        Underlying  key = toUnderlying(value);
+        if (dense)
+        {
+            if (key < toUnderlying(values[0]) || key > toUnderlying(values[N - 1]))
+            {
+                return N;
+            }
+            return static_cast<std::size_t>(key - toUnderlying(values[0]));
+        }
+        // Lower bound: If a value has two names the first one is used.
+        std::size_t first = 0;
+        std::size_t count = N;
+        while (count > 0)
+        {
+            std::size_t step = count / 2;
+            if (toUnderlying(values[first + step]) < key)
+            {
+                first += step + 1;
+                count -= step + 1;
+            }
+            else
+            {
+                count = step;
+            }
+        }
+        return (first != N && toUnderlying(values[first]) == key) ? first : N;
+    }
+    public:
+        constexpr EnumTable(E const (&enumValues)[N], char const* const (&enumNames)[N])
+        {
+            // Stable insertion sort by value.
+            for (std::size_t loop = 0; loop < N; ++loop)
+            {
+                std::size_t pos = loop;
+                for (; pos > 0 && toUnderlying(values[pos - 1]) > toUnderlying(enumValues[loop]); --pos)
+                {
+                    values[pos] = values[pos - 1];
+                    names[pos]  = names[pos - 1];
+                    sizes[pos]  = sizes[pos - 1];
+                }
+                values[pos] = enumValues[loop];
+                names[pos]  = enumNames[loop];
+                sizes[pos]  = length(enumNames[loop]);
+            }
+            for (std::size_t loop = 1; loop < N; ++loop)
+            {
+                Underlying  prev = toUnderlying(values[loop - 1]);
+                Underlying  next = toUnderlying(values[loop]);
+                dense = dense && next != prev && next - 1 == prev;
+            }
+            for (seed = 0; seed < maxSeed; ++seed)
+            {
+                if (buildHash(false))
+                {
+                    return;
+                }
+            }
+            seed = 0;
+            buildHash(true);
+        }
+        constexpr std::size_t   size() const                {return N;}
+        constexpr E             value(std::size_t index) const  {return values[index];}
+        constexpr char const*   name(std::size_t index) const   {return names[index];}
+        constexpr bool          isDense() const             {return dense;}
+
+        // nullptr if value is not one of the enum values.
+        constexpr char const* getName(E value) const
+        {
+            std::size_t index = findValue(value);
+            return index == N ? nullptr : names[index];
+        }
+        // false if name is not one of the enum names.
+        constexpr bool getValue(char const* name, std::size_t size, E& value) const
+        {
+            for (std::size_t slot = hash(seed, name, size) & hashMask; slots[slot] != emptySlot; slot = (slot + 1) & hashMask)
+            {
+                std::size_t index = slots[slot];
+                if (sizes[index] == size && equal(names[index], name, size))
+                {
+                    value = values[index];
+                    return true;
+                }
+            }
+            return false;
+        }
+};
+
 /*
  * For object that are serialized as Json Array
  * we use this object to get the size of the array.
@@ -888,38 +1301,200 @@ struct GetAllocationType<std::unique_ptr<T>>
 };
 
 /*
+ * Compact id for a polymorphic type.
+ * A 31 bit FNV-1a hash of the type name. So it is the same in every build and process
+ * and can be used in place of the name in binary formats (see PrinterConfig::polymorphicTypeId).
+ */
+using PolyMorphicTypeId = std::int32_t;
+
+constexpr std::uint32_t polyMorphicHash(char const* name, std::size_t size)
+{
+    std::uint32_t result = 2166136261u;
+    for (std::size_t loop = 0; loop < size; ++loop)
+    {
+        result ^= static_cast<unsigned char>(name[loop]);
+        result *= 16777619u;
+    }
+    return result;
+}
+constexpr PolyMorphicTypeId polyMorphicTypeId(char const* name)
+{
+    std::size_t size = 0;
+    while (name[size] != '\0')
+    {
+        ++size;
+    }
+    return static_cast<PolyMorphicTypeId>(polyMorphicHash(name, size) & 0x7FFFFFFFu);
+}
+
+/*
+ * Maps the name (or id) of a polymorphic type to a function that allocates it.
+ *
+ * Types are registered by ThorsAnvil_RegisterPolyMorphicType() during static initialization.
+ * The first lookup after a registration builds an immutable hash table (under a lock) and
+ * publishes it with an atomic pointer. All later lookups read that table without locking.
+ * A registration after this (e.g. a shared library loaded later) builds a new table;
+ * old tables are kept so a reader that is using one is not affected.
  */
 class PolyMorphicRegistry
 {
-    static std::map<std::string, std::function<void*()>>& getContainer()
+    using Allocator = void*(*)();
+    struct Entry
+    {
+        std::string         name;
+        std::size_t         hash;
+        PolyMorphicTypeId   id;
+        Allocator           alloc;
+    };
+    // Open addressing: A slot holds the entry index + 1 (0 is empty).
+    struct Table
     {
-        static std::map<std::string, std::function<void*()>>    polyAllocContainer;
+        std::vector<Entry>          entries;
+        std::vector<std::uint32_t>  byName;
+        std::vector<std::uint32_t>  byId;
+        std::size_t                 mask;
+    };
+    struct Container
+    {
+        std::mutex                              lock;
+        std::vector<Entry>                      entries;
+        std::vector<std::unique_ptr<Table>>     published;
+        std::atomic<Table const*>               current{nullptr};
+    };
+    static Container& getContainer()
+    {
+        static Container    polyAllocContainer;
         return polyAllocContainer;
     }
+    static Table const& getTable()
+    {
+        Container&      container   = getContainer();
+        Table const*    table       = container.current.load(std::memory_order_acquire);
+        if (table != nullptr)
+        {
+            return *table;
+        }
 
-    public:
-        static std::function<void*()>& getAllocator(std::string const& name)
+        std::lock_guard<std::mutex>     guard(container.lock);
+        table = container.current.load(std::memory_order_relaxed);
+        if (table != nullptr)
         {
-            return getContainer()[name];
+            return *table;
         }
-        template<typename T>
-        static T* getNamedTypeConvertedTo(std::string const& name)
+        std::unique_ptr<Table>  build   = std::make_unique<Table>();
+        std::size_t             size    = 8;
+        while (size < container.entries.size() * 2)
+        {
+            size *= 2;
+        }
+        build->entries  = container.entries;
+        build->byName.resize(size, 0);
+        build->byId.resize(size, 0);
+        build->mask     = size - 1;
+        for (std::size_t loop = 0; loop < build->entries.size(); ++loop)
         {
-            using AllocType     = typename GetAllocationType<T>::AllocType;
+            Entry const&    entry = build->entries[loop];
+            std::size_t     slot  = entry.hash & build->mask;
+            while (build->byName[slot] != 0)
+            {
+                slot = (slot + 1) & build->mask;
+            }
+            build->byName[slot] = static_cast<std::uint32_t>(loop + 1);
 
-            auto     cont       = getContainer();
-            auto     find       = cont.find(name);
-            if (find == cont.end())
+            slot = static_cast<std::uint32_t>(entry.id) & build->mask;
+            while (build->byId[slot] != 0)
+            {
+                slot = (slot + 1) & build->mask;
+            }
+            build->byId[slot] = static_cast<std::uint32_t>(loop + 1);
+        }
+        table = build.get();
+        container.published.emplace_back(std::move(build));
+        container.current.store(table, std::memory_order_release);
+        return *table;
+    }
+    static std::size_t nameHash(std::string const& name)
+    {
+        return std::hash<std::string_view>{}(name);
+    }
+    static Allocator findAllocator(std::string const& name)
+    {
+        Table const&    table   = getTable();
+        std::size_t     hash    = nameHash(name);
+        for (std::size_t slot = hash & table.mask; table.byName[slot] != 0; slot = (slot + 1) & table.mask)
+        {
+            Entry const& entry = table.entries[table.byName[slot] - 1];
+            if (entry.hash == hash && entry.name == name)
             {
-                ThorsLogAndThrow("ThorsAnvil::Serialize::PolyMorphicRegistry",
-                                 "getNamedTypeConvertedTo",
-                                 "Non polymorphic type");
+                return entry.alloc;
             }
-            void*       data        = find->second();
-            AllocType*  dataBase    = reinterpret_cast<AllocType*>(data);
+        }
+        return nullptr;
+    }
+    static Allocator findAllocator(PolyMorphicTypeId id)
+    {
+        Table const&    table   = getTable();
+        Allocator       result  = nullptr;
+        for (std::size_t slot = static_cast<std::uint32_t>(id) & table.mask; table.byId[slot] != 0; slot = (slot + 1) & table.mask)
+        {
+            Entry const& entry = table.entries[table.byId[slot] - 1];
+            if (entry.id == id)
+            {
+                if (result != nullptr)
+                {
+                    ThorsLogAndThrow("ThorsAnvil::Serialize::PolyMorphicRegistry",
+                                     "findAllocator",
+                                     "PolyMorphic type id is not unique: ", id);
+                }
+                result = entry.alloc;
+            }
+        }
+        return result;
+    }
+    template<typename T>
+    static T* convert(Allocator alloc)
+    {
+        using AllocType     = typename GetAllocationType<T>::AllocType;
+
+        if (alloc == nullptr)
+        {
+            ThorsLogAndThrow("ThorsAnvil::Serialize::PolyMorphicRegistry",
+                             "getNamedTypeConvertedTo",
+                             "Non polymorphic type");
+        }
+        void*       data        = alloc();
+        AllocType*  dataBase    = reinterpret_cast<AllocType*>(data);
+
+        using ReturnType    = T*;
+        return ReturnType{dataBase};
+    }
 
-            using ReturnType    = T*;
-            return ReturnType{dataBase};
+    public:
+        // Registering a name a second time replaces the allocator.
+        static void registerType(std::string const& name, Allocator alloc)
+        {
+            Container&                  container   = getContainer();
+            std::lock_guard<std::mutex> guard(container.lock);
+            auto find = std::find_if(std::begin(container.entries), std::end(container.entries), [&name](Entry const& entry){return entry.name == name;});
+            if (find != std::end(container.entries))
+            {
+                find->alloc = alloc;
+            }
+            else
+            {
+                container.entries.push_back(Entry{name, nameHash(name), polyMorphicTypeId(name.c_str()), alloc});
+            }
+            container.current.store(nullptr, std::memory_order_release);
+        }
+        template<typename T>
+        static T* getNamedTypeConvertedTo(std::string const& name)
+        {
+            return convert<T>(findAllocator(name));
+        }
+        template<typename T>
+        static T* getTypeIdConvertedTo(PolyMorphicTypeId id)
+        {
+            return convert<T>(findAllocator(id));
         }
 };
 
@@ -946,12 +1521,12 @@ struct ThorsAnvil_InitPolyMorphicType<T, true>
 {
     ThorsAnvil_InitPolyMorphicType(char const* name)
     {
-        PolyMorphicRegistry::getAllocator(name) =
+        PolyMorphicRegistry::registerType(name,
             []() -> void*
             {
                 using Root = typename GetRootType<T>::Root;
-                return dynamic_cast<Root*>(Traits<T*>::alloc());
-            };
+                return static_cast<Root*>(Traits<T*>::alloc());
+            });
     }
 };
 
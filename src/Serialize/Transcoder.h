@@ -0,0 +1,180 @@
+#ifndef THORS_ANVIL_SERIALIZE_TRANSCODER_H
+#define THORS_ANVIL_SERIALIZE_TRANSCODER_H
+/*
+ * Convert a document from one format to another without a C++ type.
+ *
+ *      ThorsAnvil::Serialize::transcode<From, To>(input, output)
+ *
+ * Usage:
+ *      transcode<Json, Bson>(std::cin, std::cout);     // Json document on cin written as Bson to cout
+ *      transcode<Bson, Json>(std::cin, std::cout);     // and back again.
+ *
+ * The tokens from the parser are passed directly to the printer (nothing is materialized).
+ * Values are converted using the kind reported by ParserInterface::getValueKind():
+ *      Null, Bool, Integer (int32 if it fits otherwise int64), Float (double), String.
+ * Other value kinds (e.g. Bson binary or ObjectID) can not be transcoded and cause an error.
+ *
+ * Bson output is written via BsonBackPatchPrinter (the sizes of documents are not known in advance).
+ * Bson input: A Bson document does not say if the top level object is a Map or Array (default Map).
+ * Set parserConfig.parserInfo to static_cast<long>(BsonContainer::Array) to read a top level array.
+ */
+
+#include "JsonThor.h"
+#include "BsonThor.h"
+#include "YamlThor.h"
+#include "ThorsLogging/ThorsLogging.h"
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <string>
+
+namespace ThorsAnvil
+{
+    namespace Serialize
+    {
+
+template<typename Format>
+struct TranscodePrinter
+{
+    using Printer = typename Format::Printer;
+};
+template<>
+struct TranscodePrinter<Bson>
+{
+    using Printer = BsonBackPatchPrinter;
+};
+
+inline void transcodeValue(ParserInterface& parser, PrinterInterface& printer)
+{
+    using ValueKind = ParserInterface::ValueKind;
+    switch (parser.getValueKind())
+    {
+        case ValueKind::Null:
+        {
+            parser.ignoreDataValue();
+            printer.addNull();
+            break;
+        }
+        case ValueKind::Bool:
+        {
+            bool value;
+            parser.getValue(value);
+            printer.addValue(value);
+            break;
+        }
+        case ValueKind::Integer:
+        {
+            long long int value;
+            parser.getValue(value);
+            if (value >= std::numeric_limits<std::int32_t>::min() && value <= std::numeric_limits<std::int32_t>::max())
+            {
+                printer.addValue(static_cast<int>(value));
+            }
+            else
+            {
+                printer.addValue(value);
+            }
+            break;
+        }
+        case ValueKind::Float:
+        {
+            double value;
+            parser.getValue(value);
+            printer.addValue(value);
+            break;
+        }
+        case ValueKind::String:
+        {
+            std::string value;
+            parser.getValue(value);
+            printer.addValue(value);
+            break;
+        }
+        default:
+        {
+            ThorsLogAndThrow("ThorsAnvil::Serialize::transcodeValue",
+                             "transcodeValue",
+                             "Value can not be transcoded (unknown kind)");
+        }
+    }
+}
+
+inline void transcodeTokens(ParserInterface& parser, PrinterInterface& printer)
+{
+    using ParserToken = ParserInterface::ParserToken;
+    if (parser.getToken() != ParserToken::DocStart)
+    {
+        ThorsLogAndThrow("ThorsAnvil::Serialize::transcodeTokens",
+                         "transcodeTokens",
+                         "Invalid Doc Start");
+    }
+    printer.openDoc();
+    while (true)
+    {
+        switch (parser.getToken())
+        {
+            case ParserToken::MapStart:     printer.openMap(0);                 break;
+            case ParserToken::MapEnd:       printer.closeMap();                 break;
+            case ParserToken::ArrayStart:   printer.openArray(0);               break;
+            case ParserToken::ArrayEnd:     printer.closeArray();               break;
+            case ParserToken::Key:          printer.addKey(parser.getKey());    break;
+            case ParserToken::Value:        transcodeValue(parser, printer);    break;
+            case ParserToken::DocEnd:
+            {
+                printer.closeDoc();
+                return;
+            }
+            default:
+            {
+                ThorsLogAndThrow("ThorsAnvil::Serialize::transcodeTokens",
+                                 "transcodeTokens",
+                                 "Invalid token while transcoding");
+            }
+        }
+    }
+}
+
+// @function-api
+// @param input                     Stream the document is read from (in format From).
+// @param output                    Stream the document is written to (in format To).
+// @param parserConfig              Config for the parser (see jsonImporter()/bsonImporter()/yamlImporter()).
+// @param printerConfig             Config for the printer (see jsonExporter()/bsonExporter()/yamlExporter()).
+// @return                          true on success. On failure the failbit is set on output.
+//                                  Exceptions propagate if either config has catchExceptions set to false.
+template<typename From, typename To>
+bool transcode(std::istream& input, std::ostream& output,
+               ParserInterface::ParserConfig parserConfig = ParserInterface::ParserConfig{},
+               PrinterInterface::PrinterConfig printerConfig = PrinterInterface::PrinterConfig{})
+{
+    try
+    {
+        typename From::Parser                       parser(input, parserConfig);
+        typename TranscodePrinter<To>::Printer      printer(output, printerConfig);
+        transcodeTokens(parser, printer);
+        return true;
+    }
+    catch (ThorsAnvil::Logging::CriticalException const& e)
+    {
+        ThorsCatchMessage("ThorsAnvil::Serialize", "transcode", e.what());
+        ThorsRethrowMessage("ThorsAnvil::Serialize", "transcode", e.what());
+        output.setstate(std::ios::failbit);
+        throw;
+    }
+    catch (std::exception const& e)
+    {
+        ThorsCatchMessage("ThorsAnvil::Serialize", "transcode", e.what());
+        output.setstate(std::ios::failbit);
+        if (!parserConfig.catchExceptions || !printerConfig.catchExceptions)
+        {
+            ThorsRethrowMessage("ThorsAnvil::Serialize", "transcode", e.what());
+            throw;
+        }
+    }
+    return false;
+}
+
+    }
+}
+
+#endif
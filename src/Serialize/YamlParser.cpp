@@ -2,6 +2,8 @@
 #include "YamlParser.h"
 #include "ThorsIOUtil/Utility.h"
 #include "ThorsLogging/ThorsLogging.h"
+#include <cstdlib>
+#include <cstring>
 
 using namespace ThorsAnvil::Serialize;
 
@@ -271,6 +273,44 @@ bool YamlParser::isValueNull()
 #endif
 }
 
+HEADER_ONLY_INCLUDE
+ParserInterface::ValueKind YamlParser::getValueKind()
+{
+#ifdef HAVE_YAML
+    // Quoted scalars are always strings.
+    // Plain scalars are interpreted using the YAML core schema.
+    if (event.data.scalar.style != YAML_PLAIN_SCALAR_STYLE)
+    {
+        return ValueKind::String;
+    }
+    char const* buffer  = reinterpret_cast<char const*>(event.data.scalar.value);
+    std::size_t length  = event.data.scalar.length;
+
+    if (isValueNull() || length == 0)
+    {
+        return ValueKind::Null;
+    }
+    if ((length == 4 && strncmp(buffer, "true", 4) == 0) || (length == 5 && strncmp(buffer, "false", 5) == 0))
+    {
+        return ValueKind::Bool;
+    }
+    char*   end;
+    std::strtoll(buffer, &end, 10);
+    if (end == buffer + length)
+    {
+        return ValueKind::Integer;
+    }
+    std::strtod(buffer, &end);
+    if (end == buffer + length)
+    {
+        return ValueKind::Float;
+    }
+    return ValueKind::String;
+#else
+    return ValueKind::Other;
+#endif
+}
+
 HEADER_ONLY_INCLUDE
 std::string YamlParser::getRawValue()
 {
@@ -80,6 +80,7 @@ class YamlParser: public ParserInterface
         virtual void    getValue(std::string& value)            override;
 
         virtual bool    isValueNull()                           override;
+        virtual ValueKind getValueKind()                        override;
 
         virtual std::string getRawValue()                       override;
 };
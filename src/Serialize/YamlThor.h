@@ -5,10 +5,12 @@
  *      ThorsAnvil::Serialize::Yaml
  *      ThorsAnvil::Serialize::yamlExporter
  *      ThorsAnvil::Serialize::yamlImporter
+ *      ThorsAnvil::Serialize::yamlImportFile
  *
  * Usage:
  *      std::cout << yamlExporter(object); // converts object to Yaml on an output stream
  *      std::cin  >> yamlImporter(object); // converts Yaml to a C++ object from an input stream
+ *      yamlImportFile("file", object);    // converts the content of a (memory mapped) file to a C++ object
  */
 
 
@@ -58,6 +60,17 @@ Importer<Yaml, T> yamlImporter(T& value, ParserInterface::ParserConfig config =
 {
     return Importer<Yaml, T>(value, config);
 }
+// @function-api
+// @param path                      The file to read (it is memory mapped).
+// @param value                     The object to be de-serialized.
+// @param config                    See yamlImporter().
+// @param hugePages                 Hint that huge pages should be used for the mapping (for very large files).
+// @return                          true on success.
+template<typename T>
+bool yamlImportFile(std::string const& path, T& value, ParserInterface::ParserConfig config = ParserInterface::ParserConfig{}, bool hugePages = false)
+{
+    return importFile<Yaml>(path, value, config, hugePages);
+}
 template<typename T>
 [[deprecated("Upgrade to use yamlImporter(). It has a more consistent interface. The difference is exceptions are caught by default and you need to manually turn them off. Turning the exceptions on/off is now part of the config object rahter than a seprate parameter.")]]
 Importer<Yaml, T> yamlImport(T& value, ParserInterface::ParserConfig config = ParserInterface::ParserConfig{}, bool catchExceptions = false)
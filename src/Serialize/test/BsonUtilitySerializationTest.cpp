@@ -3,6 +3,10 @@
 #include "BsonThor.h"
 #include "test/BsonUtilitySerializationTest.h"
 #include <sstream>
+#include <chrono>
+#include <set>
+#include <thread>
+#include <vector>
 
 
 using namespace ThorsAnvil::Serialize;
@@ -44,6 +48,70 @@ TEST(BsonUtilitySerializationTest, ObjectIDRoundTrip)
 
     EXPECT_EQ(object, result);
 }
+TEST(BsonUtilitySerializationTest, ObjectIDGeneratedLayout)
+{
+    using ThorsAnvil::Serialize::MongoUtility::ObjectID;
+    std::int32_t    before = ObjectID::getTimestamp();
+    ObjectID        id1;
+    ObjectID        id2;
+    std::int32_t    after  = ObjectID::getTimestamp();
+
+    std::stringstream stream;
+    stream << ThorsAnvil::Serialize::bsonExporter(std::vector<ObjectID>{id1, id2});
+    std::string result = stream.str();
+
+    // Array: size(4) + 2 * ('\x07' + "0\0" + 12 byte id) + '\0'
+    ASSERT_EQ(4 + 2 * (1 + 2 + 12) + 1, result.size());
+    std::string raw1 = result.substr(4 + 3, 12);
+    std::string raw2 = result.substr(4 + 15 + 3, 12);
+
+    std::uint32_t timestamp = (std::uint8_t(raw1[0]) << 24) | (std::uint8_t(raw1[1]) << 16) | (std::uint8_t(raw1[2]) << 8) | std::uint8_t(raw1[3]);
+    EXPECT_LE(before, static_cast<std::int32_t>(timestamp));
+    EXPECT_GE(after,  static_cast<std::int32_t>(timestamp));
+    // The random part is fixed for the process.
+    EXPECT_EQ(raw1.substr(4, 5), raw2.substr(4, 5));
+    EXPECT_NE(raw1.substr(9, 3), raw2.substr(9, 3));
+}
+
+TEST(BsonUtilitySerializationTest, ObjectIDGenerateMultiThreaded)
+{
+    using ThorsAnvil::Serialize::MongoUtility::ObjectID;
+    // Also acts as a throughput benchmark (reported as a test property).
+    static constexpr int threadCount    = 8;
+    static constexpr int idPerThread    = 200'000;
+
+    std::vector<std::vector<ObjectID>>  ids(threadCount);
+    std::vector<std::thread>            threads;
+    auto start = std::chrono::steady_clock::now();
+    for (int loop = 0; loop < threadCount; ++loop)
+    {
+        threads.emplace_back([&result = ids[loop]]()
+        {
+            result.reserve(idPerThread);
+            for (int count = 0; count < idPerThread; ++count)
+            {
+                result.emplace_back();
+            }
+        });
+    }
+    for (auto& thread: threads)
+    {
+        thread.join();
+    }
+    auto end = std::chrono::steady_clock::now();
+    auto micro = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    ::testing::Test::RecordProperty("ObjectIDPerSecond", std::to_string(micro == 0 ? 0 : (1'000'000LL * threadCount * idPerThread / micro)));
+
+    // 1.6M ids is below the 16M counter range so all must be unique
+    // (even if the timestamp did not change).
+    std::set<ObjectID>  unique;
+    for (auto const& list: ids)
+    {
+        unique.insert(std::begin(list), std::end(list));
+    }
+    EXPECT_EQ(threadCount * idPerThread, unique.size());
+}
+
 TEST(BsonUtilitySerializationTest, UTCDateTimeSerialize)
 {
     std::stringstream stream;
@@ -195,3 +263,40 @@ TEST(BsonUtilitySerializationTest, BsonRegExSerializerRoundtrip)
     EXPECT_EQ(data, result);
 }
 
+TEST(BsonUtilitySerializationTest, ObjectIDReadFromNonSeekableStream)
+{
+    using ThorsAnvil::Serialize::MongoUtility::ObjectID;
+    std::vector<ObjectID>       data{{0x12345678,0x9ABCDEF053LL,0x1A2B3C}, {0x01020304,0x0506070809LL,0x0A0B0C}};
+    std::stringstream stream;
+
+    stream << ThorsAnvil::Serialize::bsonExporter(data);
+
+    NonSeekableStreamBuf        buffer(stream.str());
+    std::istream                input(&buffer);
+    std::vector<ObjectID>       result;
+
+    input >> ThorsAnvil::Serialize::bsonImporter(result);
+
+    EXPECT_EQ(-1, input.tellg());
+    EXPECT_EQ(data, result);
+}
+TEST(BsonUtilitySerializationTest, BsonRegExReadFromNonSeekableStream)
+{
+    std::vector<MongoBsonRegExp>    data{{"^[ \\t]*", "g"}, {"[a-z]+$", "i"}};
+    std::stringstream stream;
+
+    stream << ThorsAnvil::Serialize::bsonExporter(data);
+
+    NonSeekableStreamBuf            buffer(stream.str());
+    std::istream                    input(&buffer);
+    std::vector<MongoBsonRegExp>    result;
+
+    bool importDone = false;
+    if (input >> ThorsAnvil::Serialize::bsonImporter(result))
+    {
+        importDone = true;
+    }
+
+    EXPECT_TRUE(importDone);
+    EXPECT_EQ(data, result);
+}
@@ -105,13 +105,29 @@ class MongoBsonRegExp
     friend class ThorsAnvil::Serialize::Traits<MongoBsonRegExp>;
     MongoBsonRegExObj  regex;
     public:
-        MongoBsonRegExp(std::string const& p, std::string const& o)
+        MongoBsonRegExp(std::string const& p = "", std::string const& o = "")
             : regex(p, o)
         {}
         bool operator==(MongoBsonRegExp const& rhs) const {return regex == rhs.regex;}
 };
 
 
+/*
+ * Simulates a pipe or socket.
+ * The base class std::streambuf does not support seeking so tellg() returns -1.
+ */
+class NonSeekableStreamBuf: public std::streambuf
+{
+    std::string data;
+    public:
+        NonSeekableStreamBuf(std::string const& input)
+            : data(input)
+        {
+            setg(&data[0], &data[0], &data[0] + data.size());
+        }
+};
+
+
 
 ThorsAnvil_MakeTraitCustomSerialize(MongoBsonBinaryObj,     ThorsAnvil::Serialize::MongoUtility::BinarySerializer<MongoBsonBinaryObj>);
 ThorsAnvil_MakeTraitCustomSerialize(MongoBsonJsavScriptObj, ThorsAnvil::Serialize::MongoUtility::JavascriptSerializer<MongoBsonJsavScriptObj>);
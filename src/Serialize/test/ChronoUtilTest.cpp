@@ -0,0 +1,253 @@
+#include "SerializeConfig.h"
+#include "gtest/gtest.h"
+#include "ChronoUtil.h"
+#include "JsonThor.h"
+#include "BsonThor.h"
+#include "YamlThor.h"
+#include "test/BsonUtilitySerializationTest.h"
+#include <sstream>
+
+using namespace ThorsAnvil::Serialize;
+using namespace std::chrono_literals;
+
+namespace ChronoUtilTest
+{
+    using TimePointMS   = std::chrono::time_point<std::chrono::system_clock, std::chrono::milliseconds>;
+    using TimePointS    = std::chrono::time_point<std::chrono::system_clock, std::chrono::seconds>;
+
+    struct Timing
+    {
+        std::chrono::duration<double, std::milli>   elapsed;
+    };
+    struct LogRecord
+    {
+        TimePointMS                 time;
+        std::chrono::milliseconds   elapsed;
+        std::string                 message;
+    };
+}
+
+ThorsAnvil_MakeTrait(ChronoUtilTest::LogRecord, time, elapsed, message);
+ThorsAnvil_MakeTrait(ChronoUtilTest::Timing, elapsed);
+
+using ChronoUtilTest::TimePointMS;
+using ChronoUtilTest::TimePointS;
+using ChronoUtilTest::LogRecord;
+using ChronoUtilTest::Timing;
+
+static std::string formatTime(std::int64_t seconds, std::uint32_t nanos, int digits)
+{
+    char        buffer[Chrono::iso8601TimeMaxSize];
+    std::size_t size = Chrono::formatISO8601Time(buffer, seconds, nanos, digits);
+    return std::string(buffer, size);
+}
+
+TEST(ChronoUtilTest, DaysFromCivil)
+{
+    EXPECT_EQ(0,        Chrono::daysFromCivil(1970, 1, 1));
+    EXPECT_EQ(-1,       Chrono::daysFromCivil(1969, 12, 31));
+    EXPECT_EQ(11016,    Chrono::daysFromCivil(2000, 2, 29));
+    EXPECT_EQ(-719468,  Chrono::daysFromCivil(0, 3, 1));
+
+    for (std::int64_t day = -800000; day < 3000000; day += 997)
+    {
+        std::int64_t    y;
+        unsigned        m;
+        unsigned        d;
+        Chrono::civilFromDays(day, y, m, d);
+        EXPECT_EQ(day, Chrono::daysFromCivil(y, m, d));
+    }
+}
+
+TEST(ChronoUtilTest, FormatTime)
+{
+    EXPECT_EQ("1970-01-01T00:00:00Z",               formatTime(0, 0, 0));
+    EXPECT_EQ("1969-12-31T23:59:59.999Z",           formatTime(-1, 999'000'000, 3));
+    EXPECT_EQ("2000-02-29T12:34:56.000123Z",        formatTime(951827696, 123'456, 6));
+    EXPECT_EQ("2038-01-19T03:14:08.000000001Z",     formatTime(2147483648LL, 1, 9));
+    EXPECT_EQ("9999-12-31T23:59:59Z",               formatTime(253402300799LL, 0, 0));
+    EXPECT_EQ("",                                   formatTime(253402300800LL, 0, 0));
+}
+
+TEST(ChronoUtilTest, ParseTime)
+{
+    std::int64_t    seconds;
+    std::uint32_t   nanos;
+    auto parse = [&](std::string const& value){return Chrono::parseISO8601Time(value.data(), value.data() + value.size(), seconds, nanos);};
+
+    ASSERT_TRUE(parse("2000-02-29T12:34:56.000123Z"));
+    EXPECT_EQ(951827696, seconds);
+    EXPECT_EQ(123'000, nanos);
+
+    ASSERT_TRUE(parse("2000-02-29 14:34:56.1234567891+02:00"));
+    EXPECT_EQ(951827696, seconds);
+    EXPECT_EQ(123'456'789, nanos);
+
+    ASSERT_TRUE(parse("1969-12-31t19:00:00-05:00"));
+    EXPECT_EQ(0, seconds);
+    EXPECT_EQ(0, nanos);
+
+    EXPECT_FALSE(parse("2001-02-29T00:00:00Z"));       // Not a leap year
+    EXPECT_FALSE(parse("2000-13-01T00:00:00Z"));
+    EXPECT_FALSE(parse("2000-01-01T24:00:00Z"));
+    EXPECT_FALSE(parse("2000-01-01T00:00:00"));         // No zone
+    EXPECT_FALSE(parse("2000-01-01T00:00:00.Z"));       // Empty fraction
+    EXPECT_FALSE(parse("2000-01-01T00:00:00Zx"));
+    EXPECT_FALSE(parse("2000-1-01T00:00:00Z"));
+}
+
+TEST(ChronoUtilTest, Duration)
+{
+    char            buffer[Chrono::iso8601DurationMaxSize];
+    bool            negative;
+    std::uint64_t   seconds;
+    std::uint32_t   nanos;
+    auto parse = [&](std::string const& value){return Chrono::parseISO8601Duration(value.data(), value.data() + value.size(), negative, seconds, nanos);};
+
+    EXPECT_EQ("PT90.5S",        std::string(buffer, Chrono::formatISO8601Duration(buffer, false, 90, 500'000'000, 9)));
+    EXPECT_EQ("-PT0S",          std::string(buffer, Chrono::formatISO8601Duration(buffer, true, 0, 0, 3)));
+    EXPECT_EQ("PT1.000001S",    std::string(buffer, Chrono::formatISO8601Duration(buffer, false, 1, 1'000, 9)));
+
+    ASSERT_TRUE(parse("P1DT2H3M4.5S"));
+    EXPECT_FALSE(negative);
+    EXPECT_EQ(86400 + 7200 + 180 + 4, seconds);
+    EXPECT_EQ(500'000'000, nanos);
+
+    ASSERT_TRUE(parse("-PT3M"));
+    EXPECT_TRUE(negative);
+    EXPECT_EQ(180, seconds);
+
+    EXPECT_FALSE(parse("P"));
+    EXPECT_FALSE(parse("PT"));
+    EXPECT_FALSE(parse("PT1S2M"));
+    EXPECT_FALSE(parse("P1H"));
+    EXPECT_FALSE(parse("PT1.5M3S"));
+}
+
+TEST(ChronoUtilTest, JsonTimePoint)
+{
+    LogRecord   record{TimePointMS(1'500'000'000'123ms), 2'500ms, "Start"};
+
+    std::stringstream   stream;
+    stream << jsonExporter(record, PrinterInterface::OutputType::Stream);
+    EXPECT_EQ(R"({"time":"2017-07-14T02:40:00.123Z","elapsed":"PT2.5S","message":"Start"})", stream.str());
+
+    LogRecord   result{};
+    stream >> jsonImporter(result);
+    EXPECT_EQ(record.time,      result.time);
+    EXPECT_EQ(record.elapsed,   result.elapsed);
+    EXPECT_EQ(record.message,   result.message);
+}
+
+TEST(ChronoUtilTest, JsonTimePointPrecision)
+{
+    std::stringstream   stream;
+    stream << jsonExporter(std::vector<TimePointS>{TimePointS(1'500'000'000s)}, PrinterInterface::OutputType::Stream);
+    EXPECT_EQ(R"(["2017-07-14T02:40:00Z"])", stream.str());
+
+    std::vector<TimePointS>     result;
+    std::stringstream           input(R"(["2017-07-14T02:40:00.999Z"])");
+    input >> jsonImporter(result);
+    ASSERT_EQ(1, result.size());
+    EXPECT_EQ(TimePointS(1'500'000'000s), result[0]);
+}
+
+TEST(ChronoUtilTest, JsonTimePointInvalid)
+{
+    LogRecord           result{};
+    std::stringstream   stream(R"({"time":"2017-07-14","elapsed":"PT1S","message":""})");
+    stream >> jsonImporter(result);
+    EXPECT_FALSE(stream);
+}
+
+TEST(ChronoUtilTest, BsonTimePoint)
+{
+    LogRecord   record{TimePointMS(0x123456789ALL * 1ms), 42ms, "M"};
+
+    std::stringstream   stream;
+    stream << bsonExporter(record);
+    EXPECT_EQ(stream.str().size(), bsonGetPrintSize(record));
+
+    std::string data = stream.str();
+    static const char expectedRaw[] = "\x09" "time\x00" "\x9A\x78\x56\x34\x12\x00\x00\x00"
+                                      "\x12" "elapsed\x00" "\x2A\x00\x00\x00\x00\x00\x00\x00";
+    std::string expected(std::begin(expectedRaw), std::end(expectedRaw) - 1);
+    EXPECT_EQ(expected, data.substr(4, expected.size()));
+
+    LogRecord   result{};
+    stream >> bsonImporter(result);
+    EXPECT_EQ(record.time,      result.time);
+    EXPECT_EQ(record.elapsed,   result.elapsed);
+    EXPECT_EQ(record.message,   result.message);
+}
+
+TEST(ChronoUtilTest, BsonFloatingPointDuration)
+{
+    Timing      timing{std::chrono::duration<double, std::milli>(2.5)};
+
+    std::stringstream   stream;
+    stream << bsonExporter(timing);
+    EXPECT_EQ(stream.str().size(), bsonGetPrintSize(timing));
+    // Stored as a Bson double (not truncated to an integer).
+    EXPECT_EQ('\x01', stream.str()[4]);
+    std::string const   data = stream.str();
+
+    Timing      result{};
+    stream >> bsonImporter(result);
+    EXPECT_EQ(2.5, result.elapsed.count());
+
+    // An integer duration accepts the double (rounded).
+    LogRecord           record{};
+    std::stringstream   input(data);
+    input >> bsonImporter(record);
+    EXPECT_EQ(3ms, record.elapsed);
+}
+
+TEST(ChronoUtilTest, YamlTimePoint)
+{
+    LogRecord   record{TimePointMS(1'500'000'000'123ms), 2'500ms, "Start"};
+
+    std::stringstream   stream;
+    stream << yamlExporter(record);
+
+    LogRecord   result{};
+    stream >> yamlImporter(result);
+    EXPECT_EQ(record.time,      result.time);
+    EXPECT_EQ(record.elapsed,   result.elapsed);
+}
+
+TEST(ChronoUtilTest, UTCDateTimeJson)
+{
+    MongoUTCDateTime    object(1'500'000'000'123LL);
+
+    std::stringstream   stream;
+    stream << jsonExporter(object, PrinterInterface::OutputType::Stream);
+    EXPECT_EQ(R"({"dt":"2017-07-14T02:40:00.123Z"})", stream.str());
+
+    MongoUTCDateTime    result(0);
+    stream >> jsonImporter(result);
+    EXPECT_EQ(object, result);
+
+}
+TEST(ChronoUtilTest, UTCDateTimeJsonLegacyHex)
+{
+    // The format written before ISO-8601 support: the millisecond count as 16 hex digits.
+    MongoUTCDateTime    object(1'500'000'000'123LL);
+    MongoUTCDateTime    legacy(0);
+    std::stringstream   legacyStream(R"({"dt": 0000015d3ef7987b})");
+    legacyStream >> jsonImporter(legacy);
+    EXPECT_EQ(object, legacy);
+}
+TEST(ChronoUtilTest, UTCDateTimeJsonOutOfRange)
+{
+    // After the year 9999 the legacy hex format is written.
+    MongoUTCDateTime    object(0x123456789ABCDEF0LL);
+
+    std::stringstream   stream;
+    stream << jsonExporter(object, PrinterInterface::OutputType::Stream);
+    EXPECT_EQ(R"({"dt":123456789abcdef0})", stream.str());
+
+    MongoUTCDateTime    result(0);
+    stream >> jsonImporter(result);
+    EXPECT_EQ(object, result);
+}
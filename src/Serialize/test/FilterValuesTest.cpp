@@ -19,6 +19,20 @@ struct FilterTestType
 ThorsAnvil_MakeFilter(FilterTestType, filter);
 ThorsAnvil_MakeTrait(FilterTestType, m1, m2);
 
+struct FilterMaskTestType
+{
+    std::string     m1;
+    std::string     m2;
+    int             m3;
+
+    ThorsAnvil::Serialize::FilterMask   mask;
+};
+
+ThorsAnvil_MakeFilterMask(FilterMaskTestType, mask);
+ThorsAnvil_MakeTrait(FilterMaskTestType, m1, m2, m3);
+
+using FilterMaskIndex = ThorsAnvil::Serialize::Traits<FilterMaskTestType>::MemberIndex;
+
 
 TEST(FilterMemberTests, JsonFilterOutZeroMember)
 {
@@ -192,4 +206,52 @@ TEST(FilterMemberTests, BsonFilterOutAllMember)
 
     EXPECT_EQ(expected, stream.str());
 }
+TEST(FilterMemberTests, MaskMemberIndex)
+{
+    EXPECT_EQ(0, FilterMaskIndex::m1);
+    EXPECT_EQ(1, FilterMaskIndex::m2);
+    EXPECT_EQ(2, FilterMaskIndex::m3);
+}
+TEST(FilterMemberTests, JsonFilterMaskNoneExcluded)
+{
+    FilterMaskTestType  test{"Data 1", "Other Stuff", 5, {}};
+
+    std::stringstream   stream;
+    stream << ThorsAnvil::Serialize::jsonExporter(test, ThorsAnvil::Serialize::PrinterInterface::OutputType::Stream);
 
+    EXPECT_EQ(R"({"m1":"Data 1","m2":"Other Stuff","m3":5})", stream.str());
+}
+TEST(FilterMemberTests, JsonFilterMaskOutM2Member)
+{
+    FilterMaskTestType  test{"Data 1", "Other Stuff", 5, {}};
+    test.mask.exclude(FilterMaskIndex::m2);
+
+    std::stringstream   stream;
+    stream << ThorsAnvil::Serialize::jsonExporter(test, ThorsAnvil::Serialize::PrinterInterface::OutputType::Stream);
+
+    EXPECT_EQ(R"({"m1":"Data 1","m3":5})", stream.str());
+
+    test.mask.include(FilterMaskIndex::m2);
+    test.mask.exclude(FilterMaskIndex::m1);
+    test.mask.exclude(FilterMaskIndex::m3);
+    std::stringstream   stream2;
+    stream2 << ThorsAnvil::Serialize::jsonExporter(test, ThorsAnvil::Serialize::PrinterInterface::OutputType::Stream);
+
+    EXPECT_EQ(R"({"m2":"Other Stuff"})", stream2.str());
+}
+TEST(FilterMemberTests, BsonFilterMaskOutM2Member)
+{
+    FilterMaskTestType  test{"Data 1", "Other Stuff", 5, {}};
+    test.mask.exclude(FilterMaskIndex::m2);
+    test.mask.exclude(FilterMaskIndex::m3);
+
+    std::stringstream   stream;
+    stream << ThorsAnvil::Serialize::bsonExporter(test);
+
+    std::string         expected(   "\x14\x00\x00\x00"
+                                    "\x02" "m1\x00" "\x07\x00\x00\x00" "Data 1\x00"
+                                    "\x00"s
+                                );
+
+    EXPECT_EQ(expected, stream.str());
+}
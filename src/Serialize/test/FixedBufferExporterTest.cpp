@@ -0,0 +1,197 @@
+#include "SerializeConfig.h"
+#include "gtest/gtest.h"
+#include "FixedBufferExporter.h"
+#include "CustomSerialization.h"
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ThorsAnvil::Serialize;
+
+namespace FixedBufferExporterTest
+{
+    struct Level
+    {
+        double              price;
+        long                quantity;
+    };
+    struct Quote
+    {
+        std::string         symbol;
+        long                sequence;
+        std::vector<Level>  bids;
+        std::vector<Level>  asks;
+    };
+    // Counts how many values the Serializer visits.
+    struct Counted
+    {
+        int                 value;
+        static int          visited;
+    };
+    int Counted::visited = 0;
+    struct SerializeCounted: public ThorsAnvil::Serialize::DefaultCustomSerializer<Counted>
+    {
+        virtual void writeJson(ThorsAnvil::Serialize::JsonPrinter& printer, Counted const& object) const override
+        {
+            ++Counted::visited;
+            printer.stream() << object.value;
+        }
+        virtual void readJson(ThorsAnvil::Serialize::JsonParser& parser, Counted& object) const override
+        {
+            parser.stream() >> object.value;
+        }
+    };
+}
+ThorsAnvil_MakeTrait(FixedBufferExporterTest::Level, price, quantity);
+ThorsAnvil_MakeTrait(FixedBufferExporterTest::Quote, symbol, sequence, bids, asks);
+ThorsAnvil_MakeTraitCustomSerialize(FixedBufferExporterTest::Counted, FixedBufferExporterTest::SerializeCounted);
+
+using FixedBufferExporterTest::Level;
+using FixedBufferExporterTest::Quote;
+using FixedBufferExporterTest::Counted;
+
+static Quote makeQuote(long sequence)
+{
+    return Quote{"ACME", sequence, {{101.25, 100}, {101.0, 250}, {100.75, 75}}, {{101.5, 30}, {101.75, 400}}};
+}
+
+TEST(FixedBufferExporterTest, JsonSameAsStream)
+{
+    JsonBufferExporter  exporter(PrinterInterface::OutputType::Stream);
+    char                buffer[1024];
+    for (long loop = 0; loop < 3; ++loop)
+    {
+        Quote               quote = makeQuote(loop);
+        std::stringstream   expected;
+        expected << jsonExporter(quote, PrinterInterface::OutputType::Stream);
+
+        std::size_t         size;
+        ASSERT_EQ(ExportStatus::OK, exporter.print(quote, buffer, size));
+        EXPECT_EQ(expected.str(), std::string(buffer, size));
+    }
+}
+
+TEST(FixedBufferExporterTest, BsonSameAsStream)
+{
+    BsonBufferExporter  exporter;
+    char                buffer[1024];
+    for (long loop = 0; loop < 3; ++loop)
+    {
+        Quote               quote = makeQuote(loop);
+        std::stringstream   expected;
+        expected << bsonExporter(quote);
+
+        std::size_t         size;
+        ASSERT_EQ(ExportStatus::OK, exporter.print(quote, buffer, size));
+        EXPECT_EQ(expected.str(), std::string(buffer, size));
+    }
+}
+
+TEST(FixedBufferExporterTest, JsonOverflow)
+{
+    JsonBufferExporter  exporter;
+    char                small[16];
+    char                buffer[1024];
+    std::size_t         size = 99;
+    Quote               quote = makeQuote(1);
+
+    EXPECT_EQ(ExportStatus::Overflow, exporter.print(quote, small, size));
+    EXPECT_EQ(0, size);
+
+    // The exporter can be re-used after an overflow.
+    std::stringstream   expected;
+    expected << jsonExporter(quote);
+    ASSERT_EQ(ExportStatus::OK, exporter.print(quote, buffer, size));
+    EXPECT_EQ(expected.str(), std::string(buffer, size));
+}
+
+TEST(FixedBufferExporterTest, BsonOverflow)
+{
+    BsonBufferExporter  exporter;
+    char                buffer[1024];
+    std::size_t         size;
+    Quote               quote = makeQuote(1);
+
+    std::stringstream   expected;
+    expected << bsonExporter(quote);
+    std::size_t const   exact = expected.str().size();
+
+    EXPECT_EQ(ExportStatus::Overflow, exporter.print(quote, buffer, exact - 1, size));
+    ASSERT_EQ(ExportStatus::OK, exporter.print(quote, buffer, exact, size));
+    EXPECT_EQ(exact, size);
+    EXPECT_EQ(expected.str(), std::string(buffer, size));
+}
+
+TEST(FixedBufferExporterTest, JsonOverflowStopsSerialization)
+{
+    // A large array: once the buffer is full the remaining elements are not visited.
+    std::vector<Counted>    values(10000, Counted{12345});
+    JsonBufferExporter      exporter;
+    char                    buffer[256];
+    std::size_t             size;
+
+    Counted::visited = 0;
+    EXPECT_EQ(ExportStatus::Overflow, exporter.print(values, buffer, size));
+    // Each value is at least 6 bytes so only the first ~40 fit (plus the one that overflowed).
+    EXPECT_GT(Counted::visited, 0);
+    EXPECT_LE(Counted::visited, static_cast<int>(sizeof(buffer) / 6 + 1));
+
+    // Without a limit every value is visited.
+    Counted::visited = 0;
+    std::stringstream       full;
+    full << jsonExporter(values);
+    EXPECT_EQ(10000, Counted::visited);
+}
+
+template<typename Exporter, typename StreamExport>
+static void latency(char const* name, Exporter& exporter, StreamExport streamExport)
+{
+    constexpr std::size_t   count = 20000;
+    std::vector<long>       fixed;
+    std::vector<long>       stream;
+    fixed.reserve(count);
+    stream.reserve(count);
+
+    char                    buffer[1024];
+    std::size_t             size;
+    std::size_t             total = 0;
+    for (std::size_t loop = 0; loop < count; ++loop)
+    {
+        Quote   quote = makeQuote(loop);
+
+        auto    start = std::chrono::steady_clock::now();
+        exporter.print(quote, buffer, size);
+        auto    mid   = std::chrono::steady_clock::now();
+        std::stringstream   output;
+        streamExport(output, quote);
+        std::string         result = output.str();
+        auto    end   = std::chrono::steady_clock::now();
+
+        fixed.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(mid - start).count());
+        stream.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - mid).count());
+        total += size + result.size();
+    }
+    std::sort(std::begin(fixed), std::end(fixed));
+    std::sort(std::begin(stream), std::end(stream));
+    auto percentile = [](std::vector<long> const& data, double p) {return data[static_cast<std::size_t>(p * (data.size() - 1))];};
+
+    for (double p: {0.5, 0.9, 0.99, 0.999})
+    {
+        std::string const   suffix = "P" + std::to_string(static_cast<int>(p * 1000)) + "Nano";
+        ::testing::Test::RecordProperty(std::string(name) + "FixedBuffer" + suffix, std::to_string(percentile(fixed, p)));
+        ::testing::Test::RecordProperty(std::string(name) + "StringStream" + suffix, std::to_string(percentile(stream, p)));
+    }
+    EXPECT_NE(0, total);
+}
+
+// Timing only: run with --gtest_also_run_disabled_tests (results are recorded as test properties).
+TEST(FixedBufferExporterTest, DISABLED_LatencyBenchmark)
+{
+    JsonBufferExporter  json(PrinterInterface::OutputType::Stream);
+    latency("Json", json, [](std::ostream& output, Quote const& quote){output << jsonExporter(quote, PrinterInterface::OutputType::Stream);});
+
+    BsonBufferExporter  bson;
+    latency("Bson", bson, [](std::ostream& output, Quote const& quote){output << bsonExporter(quote);});
+}
@@ -0,0 +1,147 @@
+#include "SerializeConfig.h"
+#include "gtest/gtest.h"
+#include "IOVecOutputBuffer.h"
+#include "JsonThor.h"
+#include "BsonThor.h"
+#include <sstream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+using namespace ThorsAnvil::Serialize;
+
+namespace IOVecOutputBufferTest
+{
+    struct Document
+    {
+        int                         id;
+        std::string                 name;
+        std::string                 body;
+        std::vector<std::string>    attachments;
+    };
+}
+ThorsAnvil_MakeTrait(IOVecOutputBufferTest::Document, id, name, body, attachments);
+
+using IOVecOutputBufferTest::Document;
+
+static Document makeDocument()
+{
+    return Document{12, "small", std::string(2000, 'B'), {std::string(1000, 'X'), "tiny", std::string(3000, 'Y')}};
+}
+
+static bool referenced(IOVecOutputBuffer& buffer, std::string const& value)
+{
+    for (auto const& vec: buffer.buffers())
+    {
+        if (vec.iov_base == value.data() && vec.iov_len == value.size())
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static std::string flushToPipe(IOVecOutputBuffer& buffer)
+{
+    int fd[2];
+    EXPECT_EQ(0, ::pipe(fd));
+    std::size_t size = buffer.size();
+    // A pipe holds at least 64K on Linux and the documents are much smaller.
+    EXPECT_TRUE(buffer.flush(fd[1]));
+    ::close(fd[1]);
+
+    std::string result(size, '\0');
+    std::size_t read = 0;
+    while (read != size)
+    {
+        ssize_t count = ::read(fd[0], &result[read], size - read);
+        if (count <= 0)
+        {
+            break;
+        }
+        read += count;
+    }
+    ::close(fd[0]);
+    result.resize(read);
+    return result;
+}
+
+TEST(IOVecOutputBufferTest, JsonLargeStringsAreReferenced)
+{
+    Document            document = makeDocument();
+    std::stringstream   expected;
+    expected << jsonExporter(document, PrinterInterface::OutputType::Stream);
+
+    IOVecOutputBuffer   buffer;
+    std::ostream        stream(&buffer);
+    stream << jsonExporter(document, PrinterInterface::OutputType::Stream);
+
+    EXPECT_TRUE(referenced(buffer, document.body));
+    EXPECT_TRUE(referenced(buffer, document.attachments[0]));
+    EXPECT_TRUE(referenced(buffer, document.attachments[2]));
+    EXPECT_FALSE(referenced(buffer, document.name));
+    EXPECT_EQ(expected.str().size(), buffer.size());
+    EXPECT_EQ(expected.str(), flushToPipe(buffer));
+    EXPECT_EQ(0, buffer.size());
+}
+
+TEST(IOVecOutputBufferTest, JsonEscapedStringsAreCopied)
+{
+    Document            document = makeDocument();
+    document.body[10] = '"';
+
+    std::stringstream   expected;
+    expected << jsonExporter(document);
+
+    IOVecOutputBuffer   buffer;
+    std::ostream        stream(&buffer);
+    stream << jsonExporter(document);
+
+    EXPECT_FALSE(referenced(buffer, document.body));
+    EXPECT_TRUE(referenced(buffer, document.attachments[0]));
+    EXPECT_EQ(expected.str(), flushToPipe(buffer));
+}
+
+TEST(IOVecOutputBufferTest, BsonLargeStringsAreReferenced)
+{
+    Document            document = makeDocument();
+    std::stringstream   expected;
+    expected << bsonExporter(document);
+
+    IOVecOutputBuffer   buffer;
+    std::ostream        stream(&buffer);
+    stream << bsonExporter(document);
+
+    EXPECT_TRUE(referenced(buffer, document.body));
+    EXPECT_TRUE(referenced(buffer, document.attachments[2]));
+    EXPECT_EQ(expected.str(), flushToPipe(buffer));
+}
+
+TEST(IOVecOutputBufferTest, SmallWritesShareBlocks)
+{
+    IOVecOutputBuffer   buffer(64, 16);
+    std::ostream        stream(&buffer);
+    std::string         expected;
+    for (int loop = 0; loop < 100; ++loop)
+    {
+        stream << loop << ',';
+        expected += std::to_string(loop) + ",";
+    }
+    // Blocks are only split at block boundaries.
+    EXPECT_LE(buffer.buffers().size(), expected.size() / 64 + 1);
+    EXPECT_EQ(expected, flushToPipe(buffer));
+
+    // The buffer can be re-used after a flush.
+    stream << "Again";
+    EXPECT_EQ("Again", flushToPipe(buffer));
+}
+
+TEST(IOVecOutputBufferTest, FlushErrorKeepsData)
+{
+    IOVecOutputBuffer   buffer;
+    std::ostream        stream(&buffer);
+    stream << "Data";
+    EXPECT_FALSE(buffer.flush(-1));
+    EXPECT_EQ(4, buffer.size());
+    EXPECT_EQ("Data", flushToPipe(buffer));
+}
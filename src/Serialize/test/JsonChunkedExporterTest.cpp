@@ -0,0 +1,162 @@
+#include "SerializeConfig.h"
+#include "gtest/gtest.h"
+#include "JsonChunkedExporter.h"
+#include <list>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ThorsAnvil::Serialize;
+
+namespace JsonChunkedExporterTest
+{
+    struct Row
+    {
+        std::string         key;
+        std::vector<int>    cells;
+    };
+    struct Response
+    {
+        int                 status;
+        std::vector<Row>    rows;
+    };
+    struct Meta
+    {
+        std::string         source;
+        int                 count;
+    };
+    struct Page: public Response
+    {
+        Meta                meta;
+        std::vector<std::vector<Row>>   groups;
+    };
+}
+ThorsAnvil_MakeTrait(JsonChunkedExporterTest::Row, key, cells);
+ThorsAnvil_MakeTrait(JsonChunkedExporterTest::Response, status, rows);
+ThorsAnvil_MakeTrait(JsonChunkedExporterTest::Meta, source, count);
+ThorsAnvil_ExpandTrait(JsonChunkedExporterTest::Response, JsonChunkedExporterTest::Page, meta, groups);
+
+using JsonChunkedExporterTest::Row;
+using JsonChunkedExporterTest::Response;
+using JsonChunkedExporterTest::Meta;
+using JsonChunkedExporterTest::Page;
+
+template<typename T>
+static void expectSameOutput(T const& value, std::size_t chunk)
+{
+    for (auto type: {PrinterInterface::OutputType::Default, PrinterInterface::OutputType::Stream})
+    {
+        std::stringstream       expected;
+        expected << jsonExporter(value, type);
+
+        JsonChunkedExporter<T>  exporter(value, type);
+        std::string             output;
+        std::size_t             size;
+        while ((size = exporter.nextChunk(output, chunk)) != 0)
+        {
+            EXPECT_LE(size, chunk);
+        }
+        EXPECT_TRUE(exporter.done());
+        EXPECT_EQ(expected.str(), output);
+    }
+}
+
+static std::vector<Row> makeRows(int count)
+{
+    std::vector<Row>    rows;
+    for (int loop = 0; loop < count; ++loop)
+    {
+        rows.push_back(Row{"row" + std::to_string(loop), std::vector<int>(loop % 6, loop)});
+    }
+    return rows;
+}
+
+TEST(JsonChunkedExporterTest, ArrayByElement)
+{
+    std::vector<Row>    rows = makeRows(200);
+    for (std::size_t chunk: {1, 7, 64, 4096})
+    {
+        expectSameOutput(rows, chunk);
+    }
+    expectSameOutput(std::vector<int>{}, 3);
+    expectSameOutput(std::list<std::string>{"a", "b"}, 2);
+    expectSameOutput(std::map<int, int>{{1, 2}, {3, 4}}, 5);
+}
+
+TEST(JsonChunkedExporterTest, WholeObject)
+{
+    Response            response{200, makeRows(20)};
+    for (std::size_t chunk: {1, 13, 100000})
+    {
+        expectSameOutput(response, chunk);
+    }
+    expectSameOutput(12, 1);
+}
+
+TEST(JsonChunkedExporterTest, RawBuffer)
+{
+    std::vector<int>                    data{1, 2, 3};
+    auto                                exporter = jsonChunkedExporter(data, PrinterInterface::OutputType::Stream);
+    char                                buffer[4];
+    std::string                         output;
+    while (!exporter.done())
+    {
+        std::size_t size = exporter.nextChunk(buffer, sizeof(buffer));
+        output.append(buffer, size);
+    }
+    EXPECT_EQ("[1,2,3]", output);
+    EXPECT_EQ(0, exporter.nextChunk(buffer, sizeof(buffer)));
+    EXPECT_FALSE(exporter.failed());
+}
+
+TEST(JsonChunkedExporterTest, NestedArrayIsBounded)
+{
+    // A large array inside an object is handed out one element at a time.
+    Response            response{200, makeRows(5000)};
+    std::stringstream   expected;
+    expected << jsonExporter(response, PrinterInterface::OutputType::Stream);
+    ASSERT_GT(expected.str().size(), 50000);
+
+    JsonChunkedExporter<Response>   exporter(response, PrinterInterface::OutputType::Stream);
+    std::string                     output;
+    while (exporter.nextChunk(output, 256) != 0)
+    {
+        EXPECT_LE(exporter.pendingCapacity(), 256);
+    }
+    EXPECT_TRUE(exporter.done());
+    EXPECT_EQ(expected.str(), output);
+}
+
+TEST(JsonChunkedExporterTest, ParentAndNestedObjects)
+{
+    Page                page;
+    page.status = 404;
+    page.rows   = makeRows(7);
+    page.meta   = Meta{"db", 7};
+    page.groups = {makeRows(3), {}, makeRows(2)};
+    for (std::size_t chunk: {1, 9, 100000})
+    {
+        expectSameOutput(page, chunk);
+    }
+}
+
+TEST(JsonChunkedExporterTest, Projection)
+{
+    Page                page;
+    page.status = 200;
+    page.rows   = makeRows(4);
+    page.meta   = Meta{"db", 4};
+
+    PrinterInterface::PrinterConfig config{PrinterInterface::OutputType::Stream};
+    config.withProjection({"rows.key", "meta.count"});
+    std::stringstream   expected;
+    expected << jsonExporter(page, config);
+
+    JsonChunkedExporter<Page>   exporter(page, config);
+    std::string                 output;
+    while (exporter.nextChunk(output, 5) != 0)
+    {}
+    EXPECT_EQ(expected.str(), output);
+    EXPECT_EQ(std::string::npos, output.find("cells"));
+}
@@ -0,0 +1,85 @@
+#include "SerializeConfig.h"
+#include "gtest/gtest.h"
+#include "JsonThor.h"
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ThorsAnvil::Serialize;
+
+namespace JsonExportSizeTest
+{
+    struct Item
+    {
+        std::string                 name;
+        long long                   count;
+        double                      price;
+        bool                        stock;
+        std::vector<int>            sizes;
+        std::map<std::string, int>  extra;
+    };
+}
+ThorsAnvil_MakeTrait(JsonExportSizeTest::Item, name, count, price, stock, sizes, extra);
+
+using JsonExportSizeTest::Item;
+
+static std::vector<Item> makeItems()
+{
+    return {
+        {"Plain", 12, 0.0, true, {1, 22, 333}, {{"a", 1}}},
+        {"Quote \" and \\ slash\tTab", std::numeric_limits<long long>::min(), 123.456, false, {}, {}},
+        {"", -1, -1e300, true, {std::numeric_limits<int>::max()}, {{"key with space", -7}, {"b", 0}}},
+    };
+}
+
+TEST(JsonExportSizeTest, SizeMatchesStreamOutput)
+{
+    std::vector<Item>   items = makeItems();
+    for (auto type: {PrinterInterface::OutputType::Default, PrinterInterface::OutputType::Stream, PrinterInterface::OutputType::Config})
+    {
+        std::stringstream   expected;
+        expected << jsonExporter(items, type);
+        EXPECT_EQ(expected.str().size(), jsonExportSize(items, type));
+    }
+}
+
+TEST(JsonExportSizeTest, ToStringMatchesStreamOutput)
+{
+    std::vector<Item>   items = makeItems();
+    for (auto type: {PrinterInterface::OutputType::Default, PrinterInterface::OutputType::Stream, PrinterInterface::OutputType::Config})
+    {
+        std::stringstream   expected;
+        expected << jsonExporter(items, type);
+
+        std::string         result = jsonExporterToString(items, type);
+        EXPECT_EQ(expected.str(), result);
+        EXPECT_EQ(result.size(), jsonExportSize(items, type));
+        // Note: How much reserve() allocates is up to the standard library.
+        EXPECT_GE(result.capacity(), result.size());
+    }
+}
+
+TEST(JsonExportSizeTest, SizeOfScalars)
+{
+    auto stream = PrinterInterface::OutputType::Stream;
+    EXPECT_EQ(2, jsonExportSize(std::string(""), stream));
+    EXPECT_EQ(4, jsonExportSize(std::string("\n"), stream));
+    EXPECT_EQ(4, jsonExportSize(1234, stream));
+    EXPECT_EQ(5, jsonExportSize(-1234, stream));
+    EXPECT_EQ(5, jsonExportSize(false, stream));
+    EXPECT_EQ(3, jsonExportSize(0.0, stream));
+}
+
+TEST(JsonExportSizeTest, ToStringSingleAllocation)
+{
+    std::vector<std::string>    data(1000, std::string(100, 'x'));
+    std::string                 result = jsonExporterToString(data, PrinterInterface::OutputType::Stream);
+    std::stringstream           expected;
+    expected << jsonExporter(data, PrinterInterface::OutputType::Stream);
+
+    EXPECT_EQ(1000 * 103 + 1, result.size());
+    EXPECT_EQ(expected.str(), result);
+    EXPECT_GE(result.capacity(), result.size());
+}
@@ -0,0 +1,256 @@
+#include "SerializeConfig.h"
+#include "gtest/gtest.h"
+#include "JsonLinesThor.h"
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ThorsAnvil::Serialize;
+
+namespace JsonLinesTest
+{
+    struct Event
+    {
+        std::string         level;
+        int                 code;
+        std::vector<int>    tags;
+    };
+    struct Alert: public Event
+    {
+        int                 priority = 7;
+    };
+}
+ThorsAnvil_MakeTrait(JsonLinesTest::Event, level, code, tags);
+ThorsAnvil_ExpandTrait(JsonLinesTest::Event, JsonLinesTest::Alert, priority);
+
+using JsonLinesTest::Event;
+using JsonLinesTest::Alert;
+
+TEST(JsonLinesTest, ExportOneDocumentPerLine)
+{
+    std::vector<Event>  events{{"info", 1, {1}}, {"warn", 2, {}}, {"error", 3, {4, 5}}};
+    std::stringstream   stream;
+    stream << jsonLinesExporter(events, PrinterInterface::OutputType::Config);
+
+    EXPECT_EQ("{\"level\":\"info\",\"code\":1,\"tags\":[1]}\n"
+              "{\"level\":\"warn\",\"code\":2,\"tags\":[]}\n"
+              "{\"level\":\"error\",\"code\":3,\"tags\":[4,5]}\n", stream.str());
+}
+
+TEST(JsonLinesTest, ImportRangeFor)
+{
+    std::stringstream   stream("{\"level\":\"info\",\"code\":1,\"tags\":[1]}\n"
+                               "{\"level\":\"warn\",\"code\":2}\n"
+                               "\n"
+                               "  {\"level\":\"error\",\"code\":3,\"tags\":[4,5]}");
+    std::vector<Event>  result;
+    Event const*        address = nullptr;
+    for (auto& event: jsonLinesImporter<Event>(stream))
+    {
+        // The same object is used for every record.
+        EXPECT_TRUE(address == nullptr || address == &event);
+        address = &event;
+        result.push_back(event);
+    }
+    EXPECT_TRUE(stream.eof());
+    EXPECT_FALSE(stream.fail());
+
+    ASSERT_EQ(3, result.size());
+    EXPECT_EQ("info",   result[0].level);
+    EXPECT_EQ(std::vector<int>{1}, result[0].tags);
+    EXPECT_EQ("warn",   result[1].level);
+    EXPECT_EQ(2,        result[1].code);
+    EXPECT_TRUE(result[1].tags.empty());
+    EXPECT_EQ("error",  result[2].level);
+    EXPECT_EQ((std::vector<int>{4, 5}), result[2].tags);
+}
+
+TEST(JsonLinesTest, ImportKeepsCapacity)
+{
+    std::stringstream   stream("{\"level\":\"a long level name that does not fit in the small string buffer\",\"code\":1,\"tags\":[1,2,3,4,5,6,7,8]}\n"
+                               "{\"level\":\"warn\",\"code\":2,\"tags\":[9]}\n"
+                               "{\"code\":3}\n");
+    JsonLinesImporter<Event>    importer(stream);
+
+    ASSERT_TRUE(importer.next());
+    int const*          tags            = importer.get().tags.data();
+    std::size_t         tagsCapacity    = importer.get().tags.capacity();
+    std::size_t         levelCapacity   = importer.get().level.capacity();
+
+    ASSERT_TRUE(importer.next());
+    EXPECT_EQ("warn", importer.get().level);
+    EXPECT_EQ(std::vector<int>{9}, importer.get().tags);
+    EXPECT_EQ(tags,             importer.get().tags.data());
+    EXPECT_EQ(tagsCapacity,     importer.get().tags.capacity());
+    EXPECT_EQ(levelCapacity,    importer.get().level.capacity());
+
+    ASSERT_TRUE(importer.next());
+    EXPECT_EQ("", importer.get().level);
+    EXPECT_EQ(3,  importer.get().code);
+    EXPECT_TRUE(importer.get().tags.empty());
+    EXPECT_EQ(tagsCapacity,     importer.get().tags.capacity());
+    EXPECT_FALSE(importer.next());
+}
+
+TEST(JsonLinesTest, ImportResetsParentAndDefaults)
+{
+    std::stringstream   stream("{\"level\":\"info\",\"code\":1,\"tags\":[1],\"priority\":2}\n"
+                               "{\"code\":2}\n");
+    std::vector<Alert>  result;
+    for (auto& alert: jsonLinesImporter<Alert>(stream))
+    {
+        result.push_back(alert);
+    }
+    EXPECT_FALSE(stream.fail());
+
+    ASSERT_EQ(2, result.size());
+    EXPECT_EQ(2,        result[0].priority);
+    EXPECT_EQ("",       result[1].level);
+    EXPECT_EQ(2,        result[1].code);
+    EXPECT_TRUE(result[1].tags.empty());
+    EXPECT_EQ(7,        result[1].priority);
+}
+
+TEST(JsonLinesTest, ImportScalars)
+{
+    std::stringstream   stream("1\n2 3\n-4\n");
+    std::vector<int>    result;
+    for (int value: jsonLinesImporter<int>(stream))
+    {
+        result.push_back(value);
+    }
+    EXPECT_FALSE(stream.fail());
+    EXPECT_EQ((std::vector<int>{1, 2, 3, -4}), result);
+}
+
+TEST(JsonLinesTest, ImportEmpty)
+{
+    std::stringstream   stream(" \n\n");
+    int count = 0;
+    for (auto& event: jsonLinesImporter<Event>(stream))
+    {
+        (void)event;
+        ++count;
+    }
+    EXPECT_EQ(0, count);
+    EXPECT_FALSE(stream.fail());
+}
+
+TEST(JsonLinesTest, RoundTrip)
+{
+    std::vector<Event>  events;
+    for (int loop = 0; loop < 1000; ++loop)
+    {
+        events.push_back(Event{"level" + std::to_string(loop % 7), loop, std::vector<int>(loop % 5, loop)});
+    }
+    std::stringstream   stream;
+    stream << jsonLinesExporter(events);
+
+    std::size_t index = 0;
+    for (auto& event: jsonLinesImporter<Event>(stream))
+    {
+        ASSERT_LT(index, events.size());
+        EXPECT_EQ(events[index].level, event.level);
+        EXPECT_EQ(events[index].code,  event.code);
+        EXPECT_EQ(events[index].tags,  event.tags);
+        ++index;
+    }
+    EXPECT_EQ(events.size(), index);
+}
+
+TEST(JsonLinesTest, ImportErrorStops)
+{
+    std::stringstream   stream("{\"level\":\"info\",\"code\":1}\n"
+                               "{\"level\":\"warn\",\"code\":}\n"
+                               "{\"level\":\"error\",\"code\":3}\n");
+    int count = 0;
+    for (auto& event: jsonLinesImporter<Event>(stream))
+    {
+        EXPECT_EQ("info", event.level);
+        ++count;
+    }
+    EXPECT_EQ(1, count);
+    EXPECT_TRUE(stream.fail());
+}
+
+TEST(JsonLinesTest, ImportErrorThrows)
+{
+    std::stringstream   stream("{\"level\":\"info\",\"code\":1}\n"
+                               "{\"level\":\"warn\",\"code\":}\n");
+    auto importer = [&]()
+    {
+        for (auto& event: jsonLinesImporter<Event>(stream, ParserInterface::ParserConfig{false}))
+        {
+            (void)event;
+        }
+    };
+    EXPECT_THROW(importer(), std::runtime_error);
+}
+
+TEST(JsonLinesTest, SplitAtNewLine)
+{
+    std::string                 buffer("1\n22\n333\n4444\n55555\n");
+    std::vector<char const*>    bounds = jsonLinesSplit(buffer.data(), buffer.data() + buffer.size(), 4);
+    ASSERT_LE(2, bounds.size());
+    EXPECT_EQ(buffer.data(), bounds.front());
+    EXPECT_EQ(buffer.data() + buffer.size(), bounds.back());
+    for (std::size_t loop = 1; loop < bounds.size() - 1; ++loop)
+    {
+        EXPECT_LT(bounds[loop - 1], bounds[loop]);
+        EXPECT_EQ('\n', bounds[loop][-1]);
+    }
+
+    // More chunks than lines.
+    std::vector<char const*>    small  = jsonLinesSplit(buffer.data(), buffer.data() + 4, 32);
+    EXPECT_EQ(3, small.size());
+}
+
+TEST(JsonLinesTest, ParallelImportKeepsOrder)
+{
+    std::vector<Event>  events;
+    for (int loop = 0; loop < 20000; ++loop)
+    {
+        events.push_back(Event{"level" + std::to_string(loop % 7), loop, std::vector<int>(loop % 5, loop)});
+    }
+    std::stringstream   stream;
+    stream << jsonLinesExporter(events);
+    std::string         buffer = stream.str();
+
+    for (std::size_t threads: {1, 3, 8, 64})
+    {
+        std::vector<Event>  result;
+        EXPECT_TRUE(jsonLinesParallelImport(buffer, result, ParserInterface::ParserConfig{}, threads));
+        ASSERT_EQ(events.size(), result.size());
+        for (std::size_t index = 0; index < events.size(); ++index)
+        {
+            EXPECT_EQ(events[index].code, result[index].code);
+            EXPECT_EQ(events[index].tags, result[index].tags);
+        }
+    }
+}
+
+TEST(JsonLinesTest, ParallelImportChunks)
+{
+    std::string                     buffer("1\n2\n3\n4\n5\n6\n7\n8\n");
+    std::vector<std::vector<int>>   chunks;
+    EXPECT_TRUE(jsonLinesParallelImportChunks(buffer.data(), buffer.data() + buffer.size(), chunks, ParserInterface::ParserConfig{}, 4));
+    EXPECT_EQ(4, chunks.size());
+
+    std::vector<int>    all;
+    for (auto const& chunk: chunks)
+    {
+        all.insert(all.end(), chunk.begin(), chunk.end());
+    }
+    EXPECT_EQ((std::vector<int>{1, 2, 3, 4, 5, 6, 7, 8}), all);
+}
+
+TEST(JsonLinesTest, ParallelImportError)
+{
+    std::string         buffer("1\n2\n3\n4\nx\n6\n7\n8\n");
+    std::vector<int>    result;
+    EXPECT_FALSE(jsonLinesParallelImport(buffer, result, ParserInterface::ParserConfig{}, 4));
+    EXPECT_THROW(
+        jsonLinesParallelImport(buffer, result, ParserInterface::ParserConfig{false}, 4),
+        std::runtime_error
+    );
+}
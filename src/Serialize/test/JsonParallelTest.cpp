@@ -0,0 +1,163 @@
+#include "SerializeConfig.h"
+#include "gtest/gtest.h"
+#include "JsonParallel.h"
+#include <deque>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ThorsAnvil::Serialize;
+
+namespace JsonParallelTest
+{
+    struct Snapshot
+    {
+        std::string         name;
+        long                id;
+        std::vector<double> values;
+    };
+}
+ThorsAnvil_MakeTrait(JsonParallelTest::Snapshot, name, id, values);
+
+using JsonParallelTest::Snapshot;
+
+static std::vector<std::string> elementStrings(std::string const& input)
+{
+    std::vector<JsonElementRange>   elements;
+    EXPECT_TRUE(jsonArrayElements(input.data(), input.data() + input.size(), elements));
+    std::vector<std::string>        result;
+    for (auto const& element: elements)
+    {
+        result.emplace_back(element.first, element.second);
+    }
+    return result;
+}
+static bool validArray(std::string const& input)
+{
+    std::vector<JsonElementRange>   elements;
+    return jsonArrayElements(input.data(), input.data() + input.size(), elements);
+}
+
+TEST(JsonParallelTest, ElementScan)
+{
+    EXPECT_EQ((std::vector<std::string>{}),                                 elementStrings(" [ ] "));
+    EXPECT_EQ((std::vector<std::string>{"1", "2 ", "3"}),                   elementStrings("[1, 2 , 3]"));
+    EXPECT_EQ((std::vector<std::string>{R"({"a":[1,2]})", R"("],\"x")"}),   elementStrings(R"([{"a":[1,2]},"],\"x"])"));
+    EXPECT_EQ((std::vector<std::string>{R"([[],{}])", "null"}),             elementStrings("[[[],{}],null]\n"));
+}
+
+TEST(JsonParallelTest, ElementScanInvalid)
+{
+    EXPECT_FALSE(validArray(""));
+    EXPECT_FALSE(validArray("{}"));
+    EXPECT_FALSE(validArray("[1,]"));
+    EXPECT_FALSE(validArray("[,1]"));
+    EXPECT_FALSE(validArray("[1}"));
+    EXPECT_FALSE(validArray("[1, [2]"));
+    EXPECT_FALSE(validArray(R"(["abc])"));
+    EXPECT_FALSE(validArray("[1] 2"));
+}
+
+TEST(JsonParallelTest, ImportMatchesSequential)
+{
+    std::vector<Snapshot>   snapshots;
+    for (int loop = 0; loop < 10000; ++loop)
+    {
+        snapshots.push_back(Snapshot{"s" + std::to_string(loop), loop * 3L, std::vector<double>(loop % 4, loop + 0.5)});
+    }
+    std::stringstream       stream;
+    stream << jsonExporter(snapshots);
+    std::string             buffer = stream.str();
+
+    for (std::size_t threads: {1, 4, 16})
+    {
+        std::vector<Snapshot>   result;
+        ASSERT_TRUE(jsonParallelImport(buffer, result, ParserInterface::ParserConfig{}, threads));
+        ASSERT_EQ(snapshots.size(), result.size());
+        for (std::size_t index = 0; index < snapshots.size(); ++index)
+        {
+            EXPECT_EQ(snapshots[index].name,    result[index].name);
+            EXPECT_EQ(snapshots[index].id,      result[index].id);
+            EXPECT_EQ(snapshots[index].values,  result[index].values);
+        }
+    }
+}
+
+TEST(JsonParallelTest, ImportEmpty)
+{
+    std::vector<int>    result{1, 2};
+    EXPECT_TRUE(jsonParallelImport(std::string("[]"), result));
+    EXPECT_TRUE(result.empty());
+}
+
+TEST(JsonParallelTest, ImportInvalidElement)
+{
+    std::string         buffer("[1, 2, {\"a\":3}, 4]");
+    std::vector<int>    result;
+    EXPECT_FALSE(jsonParallelImport(buffer, result, ParserInterface::ParserConfig{}, 2));
+    EXPECT_THROW(
+        jsonParallelImport(buffer, result, ParserInterface::ParserConfig{false}, 2),
+        std::runtime_error
+    );
+}
+
+TEST(JsonParallelTest, ImportInvalidArray)
+{
+    std::vector<int>    result;
+    EXPECT_FALSE(jsonParallelImport(std::string("[1, 2"), result));
+    EXPECT_THROW(
+        jsonParallelImport(std::string("[1, 2"), result, ParserInterface::ParserConfig{false}),
+        std::runtime_error
+    );
+}
+
+template<typename C>
+static void expectSameOutput(C const& container)
+{
+    for (auto type: {PrinterInterface::OutputType::Default, PrinterInterface::OutputType::Stream, PrinterInterface::OutputType::Config})
+    {
+        std::stringstream   expected;
+        expected << jsonExporter(container, type);
+        for (std::size_t threads: {1, 3, 7, 64})
+        {
+            std::stringstream   actual;
+            actual << jsonParallelExporter(container, type, threads);
+            EXPECT_EQ(expected.str(), actual.str());
+        }
+    }
+}
+
+TEST(JsonParallelTest, ExportMatchesSequential)
+{
+    std::vector<Snapshot>   snapshots;
+    for (int loop = 0; loop < 1000; ++loop)
+    {
+        snapshots.push_back(Snapshot{"s" + std::to_string(loop), loop * 3L, std::vector<double>(loop % 4, loop + 0.25)});
+    }
+    expectSameOutput(snapshots);
+}
+
+TEST(JsonParallelTest, ExportValuesAndArrays)
+{
+    expectSameOutput(std::vector<int>{});
+    expectSameOutput(std::vector<int>{1});
+    expectSameOutput(std::vector<std::string>{"a", "b", "c", "d", "e"});
+    expectSameOutput(std::vector<std::vector<int>>{{}, {1}, {2, 3}, {4, 5, 6}});
+    expectSameOutput(std::deque<double>{0.0, 1.5, -2.25, 1e100});
+}
+
+TEST(JsonParallelTest, ExportRoundTrip)
+{
+    std::vector<Snapshot>   snapshots;
+    for (int loop = 0; loop < 5000; ++loop)
+    {
+        snapshots.push_back(Snapshot{"s" + std::to_string(loop), loop, {loop * 1.0}});
+    }
+    std::stringstream       stream;
+    stream << jsonParallelExporter(snapshots, PrinterInterface::OutputType::Stream, 8);
+
+    std::vector<Snapshot>   result;
+    ASSERT_TRUE(jsonParallelImport(stream.str(), result, ParserInterface::ParserConfig{}, 8));
+    ASSERT_EQ(snapshots.size(), result.size());
+    EXPECT_EQ(snapshots.back().name, result.back().name);
+}
@@ -0,0 +1,177 @@
+#include "SerializeConfig.h"
+#include "gtest/gtest.h"
+#include "JsonPushImporter.h"
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace ThorsAnvil::Serialize;
+
+namespace JsonPushImporterTest
+{
+    struct Upload
+    {
+        std::string                     name;
+        std::vector<int>                blocks;
+        std::map<std::string, double>   meta;
+    };
+}
+ThorsAnvil_MakeTrait(JsonPushImporterTest::Upload, name, blocks, meta);
+
+using JsonPushImporterTest::Upload;
+
+static std::string const uploadJson = R"({"name": "a \"}]\\ b", "blocks": [1, 2, 3], "meta": {"x": 1.5, "y": -2}})";
+
+TEST(JsonPushImporterTest, OneChunk)
+{
+    Upload                      upload;
+    JsonPushImporter<Upload>    importer(upload);
+    EXPECT_EQ(PushStatus::Done, importer.feed(uploadJson));
+    EXPECT_EQ(uploadJson.size(), importer.consumed());
+    EXPECT_EQ("a \"}]\\ b", upload.name);
+    EXPECT_EQ((std::vector<int>{1, 2, 3}), upload.blocks);
+    EXPECT_EQ(-2, upload.meta["y"]);
+}
+
+TEST(JsonPushImporterTest, EveryChunkSize)
+{
+    for (std::size_t chunk = 1; chunk <= uploadJson.size(); ++chunk)
+    {
+        Upload                      upload;
+        JsonPushImporter<Upload>    importer(upload);
+        PushStatus                  status = PushStatus::NeedMoreData;
+        std::size_t                 offset = 0;
+        for (; offset < uploadJson.size() && status == PushStatus::NeedMoreData; offset += chunk)
+        {
+            status = importer.feed(uploadJson.data() + offset, std::min(chunk, uploadJson.size() - offset));
+        }
+        ASSERT_EQ(PushStatus::Done, status);
+        EXPECT_EQ(uploadJson.size(), offset - chunk + importer.consumed());
+        EXPECT_EQ("a \"}]\\ b", upload.name);
+        EXPECT_EQ(1.5, upload.meta["x"]);
+    }
+}
+
+TEST(JsonPushImporterTest, SeveralDocumentsInOneChunk)
+{
+    std::string                 input("[1,2] [3]\n[4,5,6]");
+    std::vector<int>            value;
+    JsonPushImporter<std::vector<int>>  importer(value);
+
+    std::vector<std::vector<int>>   result;
+    char const*                 data = input.data();
+    std::size_t                 size = input.size();
+    while (importer.feed(data, size) == PushStatus::Done)
+    {
+        result.push_back(value);
+        data += importer.consumed();
+        size -= importer.consumed();
+        value.clear();
+        importer.reset();
+    }
+    EXPECT_EQ(PushStatus::NeedMoreData, importer.getStatus());
+    EXPECT_EQ((std::vector<std::vector<int>>{{1, 2}, {3}, {4, 5, 6}}), result);
+}
+
+TEST(JsonPushImporterTest, TopLevelScalar)
+{
+    int                     value   = 0;
+    JsonPushImporter<int>   importer(value);
+    EXPECT_EQ(PushStatus::NeedMoreData, importer.feed(" 12"));
+    EXPECT_EQ(PushStatus::NeedMoreData, importer.feed("3"));
+    EXPECT_EQ(PushStatus::Done,         importer.finish());
+    EXPECT_EQ(123, value);
+
+    importer.reset();
+    EXPECT_EQ(PushStatus::Done,         importer.feed("45 "));
+    EXPECT_EQ(2,  importer.consumed());
+    EXPECT_EQ(45, value);
+
+    std::string             text;
+    JsonPushImporter<std::string>   stringImporter(text);
+    EXPECT_EQ(PushStatus::NeedMoreData, stringImporter.feed("\"ab"));
+    EXPECT_EQ(PushStatus::Done,         stringImporter.feed("c\""));
+    EXPECT_EQ("abc", text);
+}
+
+TEST(JsonPushImporterTest, StructureError)
+{
+    std::vector<std::vector<int>>                   value;
+    JsonPushImporter<std::vector<std::vector<int>>> importer(value);
+    EXPECT_EQ(PushStatus::NeedMoreData, importer.feed("[[1], ["));
+    // Reported as soon as the bad bracket arrives.
+    EXPECT_EQ(PushStatus::Error,        importer.feed("}"));
+    EXPECT_EQ(1, importer.consumed());
+    EXPECT_FALSE(importer.error().empty());
+    EXPECT_EQ(PushStatus::Error,        importer.feed("]]"));
+}
+
+TEST(JsonPushImporterTest, ParseError)
+{
+    std::vector<int>                    value;
+    JsonPushImporter<std::vector<int>>  importer(value);
+    EXPECT_EQ(PushStatus::Error,        importer.feed("[1, 2 3]"));
+
+    JsonPushImporter<std::vector<int>>  throwing(value, ParserInterface::ParserConfig{false});
+    EXPECT_EQ(PushStatus::NeedMoreData, throwing.feed("[1, "));
+    EXPECT_THROW(throwing.feed("x]"), std::runtime_error);
+}
+
+TEST(JsonPushImporterTest, FinishIncomplete)
+{
+    std::vector<int>                    value;
+    JsonPushImporter<std::vector<int>>  importer(value);
+    EXPECT_EQ(PushStatus::NeedMoreData, importer.feed("[1, 2"));
+    EXPECT_EQ(PushStatus::Error,        importer.finish());
+}
+
+TEST(JsonPushImporterTest, DeSerializesWhileDataArrives)
+{
+    Upload                      upload;
+    JsonPushImporter<Upload>    importer(upload);
+    EXPECT_EQ(PushStatus::NeedMoreData, importer.feed(R"({"name": "first", "blocks": [1, 2)"));
+    // The data so far has already been read into the object.
+    EXPECT_EQ("first", upload.name);
+    ASSERT_FALSE(upload.blocks.empty());
+    EXPECT_EQ(1, upload.blocks[0]);
+
+    EXPECT_EQ(PushStatus::NeedMoreData, importer.feed(R"(, 3], "meta": {"x")"));
+    EXPECT_EQ((std::vector<int>{1, 2, 3}), upload.blocks);
+    EXPECT_EQ(PushStatus::Done,         importer.feed(R"(: 4}} trailing)"));
+    EXPECT_EQ(5, importer.consumed());
+    EXPECT_EQ(4, upload.meta["x"]);
+}
+
+TEST(JsonPushImporterTest, ChunkBufferIsReused)
+{
+    // The importer does not keep a reference to the data passed to feed().
+    Upload                      upload;
+    JsonPushImporter<Upload>    importer(upload);
+    char                        buffer[7];
+    PushStatus                  status = PushStatus::NeedMoreData;
+    for (std::size_t offset = 0; offset < uploadJson.size() && status == PushStatus::NeedMoreData; offset += sizeof(buffer))
+    {
+        std::size_t size = uploadJson.copy(buffer, sizeof(buffer), offset);
+        status = importer.feed(buffer, size);
+        std::fill(std::begin(buffer), std::end(buffer), 'X');
+    }
+    ASSERT_EQ(PushStatus::Done, status);
+    EXPECT_EQ("a \"}]\\ b", upload.name);
+    EXPECT_EQ((std::vector<int>{1, 2, 3}), upload.blocks);
+}
+
+TEST(JsonPushImporterTest, ResetPartWayThrough)
+{
+    std::vector<int>                    value;
+    JsonPushImporter<std::vector<int>>  importer(value, ParserInterface::ParserConfig{false});
+    EXPECT_EQ(PushStatus::NeedMoreData, importer.feed("[1, 2"));
+    importer.reset();
+    value.clear();
+    EXPECT_EQ(PushStatus::Done,         importer.feed("[5, 6]"));
+    EXPECT_EQ((std::vector<int>{5, 6}), value);
+
+    // finish() without a document.
+    importer.reset();
+    EXPECT_THROW(importer.finish(), std::runtime_error);
+}
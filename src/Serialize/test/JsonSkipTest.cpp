@@ -0,0 +1,115 @@
+#include "SerializeConfig.h"
+#include "gtest/gtest.h"
+#include "JsonThor.h"
+#include <chrono>
+#include <sstream>
+#include <string>
+
+using namespace ThorsAnvil::Serialize;
+
+namespace JsonSkipTest
+{
+    struct Small
+    {
+        int             id;
+        std::string     name;
+    };
+}
+ThorsAnvil_MakeTrait(JsonSkipTest::Small, id, name);
+
+using JsonSkipTest::Small;
+
+static std::string const skipInput = R"(
+{
+    "extra":    {"a": [1, 2, {"b": "}]"}], "c": "quote \" and slash \\", "d": "\\\\"},
+    "id":       12,
+    "more":     [[], {}, ["[", "{"], {"x": {"y": [null, true, false, 1.5e3]}}],
+    "name":     "Loki",
+    "last":     {"\"key\"": "val\\"}
+}
+)";
+
+static bool importFromMemory(std::string const& input, Small& value)
+{
+    MemoryInputBuffer   buffer(input.data(), input.data() + input.size());
+    std::istream        stream(&buffer);
+    return static_cast<bool>(stream >> jsonImporter(value));
+}
+
+static bool importFromStream(std::string const& input, Small& value)
+{
+    std::stringstream   stream(input);
+    return static_cast<bool>(stream >> jsonImporter(value));
+}
+
+TEST(JsonSkipTest, SkipNestedContainersInMemory)
+{
+    Small   value{};
+    EXPECT_TRUE(importFromMemory(skipInput, value));
+    EXPECT_EQ(12, value.id);
+    EXPECT_EQ("Loki", value.name);
+}
+
+TEST(JsonSkipTest, SkipNestedContainersInStream)
+{
+    Small   value{};
+    EXPECT_TRUE(importFromStream(skipInput, value));
+    EXPECT_EQ(12, value.id);
+    EXPECT_EQ("Loki", value.name);
+}
+
+TEST(JsonSkipTest, SkipIgnoredArrayElementsOfVector)
+{
+    std::vector<Small>  value;
+    std::string         input = R"([{"id": 1, "x": [[{}]], "name": "A"}, {"y": {"z": "]"}, "id": 2, "name": "B"}])";
+    std::stringstream   stream(input);
+    EXPECT_TRUE(stream >> jsonImporter(value));
+    ASSERT_EQ(2, value.size());
+    EXPECT_EQ(2, value[1].id);
+    EXPECT_EQ("B", value[1].name);
+}
+
+TEST(JsonSkipTest, MismatchedBracketsInIgnoredValue)
+{
+    Small   value{};
+    EXPECT_FALSE(importFromMemory(R"({"extra": [1, 2}, "id": 1, "name": "A"})", value));
+    EXPECT_FALSE(importFromStream(R"({"extra": [1, 2}, "id": 1, "name": "A"})", value));
+}
+
+TEST(JsonSkipTest, UnterminatedIgnoredValue)
+{
+    Small   value{};
+    EXPECT_FALSE(importFromMemory(R"({"extra": [1, "2]})", value));
+    EXPECT_FALSE(importFromStream(R"({"extra": [1, "2]})", value));
+    EXPECT_FALSE(importFromMemory(R"({"extra": {"a": [1, 2])", value));
+    EXPECT_FALSE(importFromStream(R"({"extra": {"a": [1, 2])", value));
+}
+
+// Timing only: run with --gtest_also_run_disabled_tests (results are recorded as test properties).
+TEST(JsonSkipTest, DISABLED_Benchmark)
+{
+    // Most of each record is ignored.
+    std::string     input = "[";
+    for (int loop = 0; loop < 2000; ++loop)
+    {
+        input += std::string(loop == 0 ? "" : ",")
+              +  R"({"id": )" + std::to_string(loop)
+              +  R"(, "entities": {"urls": [{"url": "http://t.co/abc", "indices": [1, 20]}], "tags": ["a", "b", "c"]})"
+              +  R"(, "user": {"screen_name": "name", "description": "A \"long\" description of the user", "counts": [1, 2, 3, 4, 5]})"
+              +  R"(, "name": "N"})";
+    }
+    input += "]";
+
+    auto start = std::chrono::steady_clock::now();
+    for (int loop = 0; loop < 5; ++loop)
+    {
+        std::vector<Small>  value;
+        MemoryInputBuffer   buffer(input.data(), input.data() + input.size());
+        std::istream        stream(&buffer);
+        EXPECT_TRUE(stream >> jsonImporter(value));
+        EXPECT_EQ(2000, value.size());
+    }
+    auto time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    ::testing::Test::RecordProperty("JsonImportBytes", std::to_string(input.size()));
+    ::testing::Test::RecordProperty("IgnoreMostX5Micro", std::to_string(time));
+}
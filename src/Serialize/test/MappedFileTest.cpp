@@ -0,0 +1,136 @@
+#include "SerializeConfig.h"
+#include "gtest/gtest.h"
+#include "MappedFile.h"
+#include "JsonThor.h"
+#include "BsonThor.h"
+#include "YamlThor.h"
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+using namespace ThorsAnvil::Serialize;
+
+namespace MappedFileTest
+{
+    struct Config
+    {
+        std::string                 name;
+        int                         version;
+        std::vector<std::string>    servers;
+    };
+
+    class TempFile
+    {
+        std::string     path;
+        public:
+            TempFile(std::string const& content)
+                : path("/tmp/MappedFileTest." + std::to_string(::getpid()) + "." + std::to_string(reinterpret_cast<std::uintptr_t>(this)))
+            {
+                std::ofstream   file(path, std::ios::binary);
+                file << content;
+            }
+            ~TempFile()
+            {
+                std::remove(path.c_str());
+            }
+            std::string const& name() const {return path;}
+    };
+}
+ThorsAnvil_MakeTrait(MappedFileTest::Config, name, version, servers);
+
+using MappedFileTest::Config;
+using MappedFileTest::TempFile;
+
+TEST(MappedFileTest, MapFile)
+{
+    TempFile    temp("Hello World");
+    MappedFile  file(temp.name(), true);
+    ASSERT_TRUE(static_cast<bool>(file));
+    EXPECT_EQ(11, file.size());
+    EXPECT_EQ("Hello World", std::string(file.begin(), file.end()));
+}
+
+TEST(MappedFileTest, MapEmptyFile)
+{
+    TempFile    temp("");
+    MappedFile  file(temp.name());
+    ASSERT_TRUE(static_cast<bool>(file));
+    EXPECT_EQ(0, file.size());
+    EXPECT_EQ(file.begin(), file.end());
+}
+
+TEST(MappedFileTest, MapMissingFile)
+{
+    MappedFile  file("/tmp/MappedFileTest.does.not.exist");
+    EXPECT_FALSE(static_cast<bool>(file));
+}
+
+TEST(MappedFileTest, JsonImportFile)
+{
+    TempFile    temp(R"({"name": "main", "version": 3, "servers": ["a", "b"]})");
+    Config      config;
+    ASSERT_TRUE(jsonImportFile(temp.name(), config));
+    EXPECT_EQ("main", config.name);
+    EXPECT_EQ(3, config.version);
+    EXPECT_EQ((std::vector<std::string>{"a", "b"}), config.servers);
+}
+
+TEST(MappedFileTest, JsonImportFileInvalid)
+{
+    TempFile    temp(R"({"name": "main", "version": )");
+    Config      config;
+    EXPECT_FALSE(jsonImportFile(temp.name(), config));
+    EXPECT_THROW(
+        jsonImportFile(temp.name(), config, ParserInterface::ParserConfig{false}),
+        std::runtime_error
+    );
+}
+
+TEST(MappedFileTest, JsonImportFileMissing)
+{
+    Config      config;
+    EXPECT_FALSE(jsonImportFile("/tmp/MappedFileTest.does.not.exist", config));
+    EXPECT_THROW(
+        jsonImportFile("/tmp/MappedFileTest.does.not.exist", config, ParserInterface::ParserConfig{false}),
+        std::runtime_error
+    );
+}
+
+TEST(MappedFileTest, BsonImportFile)
+{
+    Config              input{"main", 3, {"a", "b"}};
+    std::stringstream   stream;
+    stream << bsonExporter(input);
+    TempFile            temp(stream.str());
+
+    Config              config;
+    ASSERT_TRUE(bsonImportFile(temp.name(), config, ParserInterface::ParserConfig{}, true));
+    EXPECT_EQ("main", config.name);
+    EXPECT_EQ(3, config.version);
+    EXPECT_EQ(input.servers, config.servers);
+
+    std::vector<int>    array{1, 2, 3};
+    std::stringstream   arrayStream;
+    arrayStream << bsonExporter(array);
+    TempFile            arrayTemp(arrayStream.str());
+
+    std::vector<int>    arrayResult;
+    ASSERT_TRUE(bsonImportFile(arrayTemp.name(), arrayResult));
+    EXPECT_EQ(array, arrayResult);
+}
+
+#ifdef HAVE_YAML
+TEST(MappedFileTest, YamlImportFile)
+{
+    TempFile    temp("name: main\nversion: 3\nservers:\n  - a\n  - b\n");
+    Config      config;
+    ASSERT_TRUE(yamlImportFile(temp.name(), config));
+    EXPECT_EQ("main", config.name);
+    EXPECT_EQ(3, config.version);
+    EXPECT_EQ((std::vector<std::string>{"a", "b"}), config.servers);
+}
+#endif
@@ -0,0 +1,276 @@
+#include "SerializeConfig.h"
+#include "gtest/gtest.h"
+#include "MongoOpMsg.h"
+#include "test/MongoOpMsgTest.h"
+#include "test/BsonUtilitySerializationTest.h"
+#include <sstream>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include <sys/socket.h>
+
+using namespace ThorsAnvil::Serialize;
+using namespace ThorsAnvil::Serialize::MongoUtility;
+using OpMsgTest::Person;
+using OpMsgTest::InsertReply;
+
+TEST(MongoOpMsgTest, BuildBodyOnly)
+{
+    OpMsgBuilder    builder(7, 3);
+    builder.addBody(Person{"Bob", 12});
+
+    std::string const& message = builder.finish();
+    std::string body = message.substr(21);
+
+    std::stringstream   expectedBody;
+    expectedBody << bsonExporter(Person{"Bob", 12});
+
+    static const char expectedHeaderRaw[]
+                = "\x31\x00\x00\x00"    // messageLength (16 + 4 + 1 + 28)
+                  "\x07\x00\x00\x00"    // requestID
+                  "\x03\x00\x00\x00"    // responseTo
+                  "\xDD\x07\x00\x00"    // opCode 2013
+                  "\x00\x00\x00\x00"    // flags
+                  "\x00";               // Kind 0
+    std::string expectedHeader(std::begin(expectedHeaderRaw), std::end(expectedHeaderRaw) - 1);
+
+    EXPECT_EQ(expectedHeader, message.substr(0, 21));
+    EXPECT_EQ(expectedBody.str(), body);
+    EXPECT_EQ(message.size(), 21 + expectedBody.str().size());
+}
+
+TEST(MongoOpMsgTest, BuildSequenceSizeIsPatched)
+{
+    OpMsgBuilder    builder(1);
+    builder.addBody(InsertCommand{"people", "test", true})
+           .openSequence("documents")
+           .addDocument(Person{"Ann", 1})
+           .addDocument(Person{"Ben", 2})
+           .closeSequence();
+
+    std::string const& message = builder.finish();
+    std::size_t bodySize  = bsonGetPrintSize(InsertCommand{"people", "test", true});
+    std::size_t seqStart  = 16 + 4 + 1 + bodySize;
+    std::size_t docSize   = bsonGetPrintSize(Person{"Ann", 1});
+
+    EXPECT_EQ('\x01', message[seqStart]);
+    std::int32_t seqSize;
+    std::memcpy(&seqSize, message.data() + seqStart + 1, 4);
+    EXPECT_EQ(4 + 10 + 2 * docSize, seqSize);
+    EXPECT_EQ(std::string("documents"), std::string(message.data() + seqStart + 5));
+    EXPECT_EQ(message.size(), seqStart + 1 + seqSize);
+}
+
+TEST(MongoOpMsgTest, BodyTwiceThrows)
+{
+    OpMsgBuilder    builder(1);
+    builder.addBody(Person{"Ann", 1});
+    EXPECT_THROW(
+        builder.addBody(Person{"Ann", 1}),
+        std::runtime_error
+    );
+}
+
+TEST(MongoOpMsgTest, DocumentWithoutSequenceThrows)
+{
+    OpMsgBuilder    builder(1);
+    builder.addBody(Person{"Ann", 1});
+    EXPECT_THROW(
+        builder.addDocument(Person{"Ann", 1}),
+        std::runtime_error
+    );
+}
+
+TEST(MongoOpMsgTest, RoundTripWithChecksum)
+{
+    std::vector<Person> people{{"Ann", 1}, {"Ben", 2}, {"Cat", 3}};
+    OpMsgBuilder    builder(42, 0, static_cast<std::uint32_t>(OpMsgFlag::ChecksumPresent));
+    builder.addBody(InsertCommand{"people", "test", false})
+           .openSequence("documents")
+           .addDocuments(std::begin(people), std::end(people));
+
+    std::string const&  message = builder.finish();
+    std::uint32_t       expectedCrc = crc32c(message.data(), message.size() - 4);
+
+    // Use a non seekable stream to make sure the reader only moves forward.
+    std::string                 data = message;
+    NonSeekableStreamBuf        buffer(data);
+    std::istream                stream(&buffer);
+
+    OpMsgReader     reader(stream);
+    EXPECT_EQ(42, reader.getHeader().requestID);
+    EXPECT_TRUE(reader.getFlags() & OpMsgFlag::ChecksumPresent);
+
+    ASSERT_TRUE(reader.nextSection());
+    EXPECT_EQ(OpMsgSectionKind::Body, reader.getSectionKind());
+    InsertCommand   command{};
+    EXPECT_TRUE(reader.readDocument(command));
+    EXPECT_EQ("people", command.insert);
+    EXPECT_EQ("test", command.db);
+    EXPECT_FALSE(command.ordered);
+
+    ASSERT_TRUE(reader.nextSection());
+    EXPECT_EQ(OpMsgSectionKind::DocumentSequence, reader.getSectionKind());
+    EXPECT_EQ("documents", reader.getIdentifier());
+    std::vector<Person> result;
+    Person  person;
+    while (reader.readDocument(person))
+    {
+        result.emplace_back(person);
+    }
+    EXPECT_EQ(people, result);
+
+    EXPECT_FALSE(reader.nextSection());
+    EXPECT_EQ(expectedCrc, reader.getChecksum());
+    EXPECT_EQ(EOF, stream.peek());
+}
+
+TEST(MongoOpMsgTest, ReaderSkipsUnreadSections)
+{
+    std::stringstream   stream;
+    OpMsgBuilder        builder(1);
+    builder.addBody(Person{"Ann", 1})
+           .openSequence("a")
+           .addDocument(Person{"Ben", 2})
+           .closeSequence()
+           .openSequence("b")
+           .addDocument(Person{"Cat", 3});
+    stream << builder;
+    builder.reset(2);
+    builder.addBody(Person{"Dan", 4});
+    stream << builder;
+
+    OpMsgReader     first(stream);
+    EXPECT_TRUE(first.nextSection());
+    EXPECT_TRUE(first.nextSection());
+    EXPECT_TRUE(first.nextSection());
+    EXPECT_EQ("b", first.getIdentifier());
+    EXPECT_FALSE(first.nextSection());
+
+    OpMsgReader     second(stream);
+    EXPECT_EQ(2, second.getHeader().requestID);
+    ASSERT_TRUE(second.nextSection());
+    Person  person;
+    EXPECT_TRUE(second.readDocument(person));
+    EXPECT_EQ((Person{"Dan", 4}), person);
+    EXPECT_FALSE(second.nextSection());
+}
+
+TEST(MongoOpMsgTest, BatcherSplitsOnCount)
+{
+    std::vector<Person> people;
+    for (int loop = 0; loop < 10; ++loop)
+    {
+        people.emplace_back(Person{"P" + std::to_string(loop), loop});
+    }
+    std::stringstream   stream;
+    OpMsgInsertBatcher  batcher(stream, "test", "people", 100, opMsgDefaultMaxSize, 4);
+    EXPECT_EQ(3, batcher.insert(std::begin(people), std::end(people)));
+    EXPECT_EQ((std::vector<std::int32_t>{100, 101, 102}), batcher.getRequestIDs());
+
+    std::vector<Person> result;
+    for (int message = 0; message < 3; ++message)
+    {
+        OpMsgReader reader(stream);
+        EXPECT_EQ(100 + message, reader.getHeader().requestID);
+        reader.nextSection();
+        reader.nextSection();
+        Person  person;
+        while (reader.readDocument(person))
+        {
+            result.emplace_back(person);
+        }
+        EXPECT_FALSE(reader.nextSection());
+    }
+    EXPECT_EQ(people, result);
+}
+
+TEST(MongoOpMsgTest, BatcherSplitsOnSize)
+{
+    std::vector<Person> people(6, Person{"Name", 1});
+    std::size_t headerSize  = 16 + 4 + 1 + bsonGetPrintSize(InsertCommand{"people", "test", true}) + 1 + 4 + 10;
+    std::size_t docSize     = bsonGetPrintSize(people[0]);
+
+    std::stringstream   stream;
+    OpMsgInsertBatcher  batcher(stream, "test", "people", 1, headerSize + 2 * docSize);
+    EXPECT_EQ(3, batcher.insert(std::begin(people), std::end(people)));
+
+    OpMsgInsertBatcher  tooSmall(stream, "test", "people", 1, headerSize + docSize - 1);
+    EXPECT_THROW(
+        tooSmall.insert(std::begin(people), std::end(people)),
+        std::runtime_error
+    );
+}
+
+TEST(MongoOpMsgTest, PipelinedInsertAgainstStandInServer)
+{
+    int sockets[2];
+    ASSERT_EQ(0, ::socketpair(AF_UNIX, SOCK_STREAM, 0, sockets));
+
+    // Stand in server: reads "insert" messages and replies {ok: 1, n: <count>}.
+    // It only starts replying once the client has shut down its write side,
+    // so the client must be able to send all batches without waiting.
+    std::thread server([fd = sockets[1]]()
+    {
+        OpMsgTest::FdStreamBuf  buffer(fd);
+        std::iostream           stream(&buffer);
+        std::vector<std::pair<std::int32_t, int>>   received;
+        while (stream.peek() != EOF)
+        {
+            OpMsgReader     reader(stream);
+            int             count = 0;
+            while (reader.nextSection())
+            {
+                if (reader.getSectionKind() == OpMsgSectionKind::Body)
+                {
+                    InsertCommand   command{};
+                    reader.readDocument(command);
+                    continue;
+                }
+                Person  person;
+                while (reader.readDocument(person))
+                {
+                    ++count;
+                }
+            }
+            received.emplace_back(reader.getHeader().requestID, count);
+        }
+        stream.clear();
+        OpMsgBuilder    reply(0);
+        for (auto const& item: received)
+        {
+            reply.reset(1000 + item.first, item.first);
+            reply.addBody(InsertReply{1.0, item.second});
+            stream << reply;
+        }
+        ::close(fd);
+    });
+
+    std::vector<Person> people;
+    for (int loop = 0; loop < 25; ++loop)
+    {
+        people.emplace_back(Person{"Person" + std::to_string(loop), loop});
+    }
+    OpMsgTest::FdStreamBuf  buffer(sockets[0]);
+    std::iostream           stream(&buffer);
+    OpMsgInsertBatcher      batcher(stream, "test", "people", 1, opMsgDefaultMaxSize, 10);
+    EXPECT_EQ(3, batcher.insert(std::begin(people), std::end(people)));
+    ::shutdown(sockets[0], SHUT_WR);
+
+    std::vector<int> counts;
+    for (std::int32_t requestID: batcher.getRequestIDs())
+    {
+        OpMsgReader     reader(stream);
+        EXPECT_EQ(requestID, reader.getHeader().responseTo);
+        ASSERT_TRUE(reader.nextSection());
+        InsertReply     result{};
+        EXPECT_TRUE(reader.readDocument(result));
+        EXPECT_EQ(1.0, result.ok);
+        counts.emplace_back(result.n);
+        EXPECT_FALSE(reader.nextSection());
+    }
+    server.join();
+    ::close(sockets[0]);
+
+    EXPECT_EQ((std::vector<int>{10, 10, 5}), counts);
+}
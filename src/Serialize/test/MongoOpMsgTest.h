@@ -0,0 +1,79 @@
+#ifndef THORS_ANVIL_SERIALIZE_TEST_MONGO_OP_MSG_TEST_H
+#define THORS_ANVIL_SERIALIZE_TEST_MONGO_OP_MSG_TEST_H
+
+#include "Traits.h"
+#include "MongoOpMsg.h"
+#include <streambuf>
+#include <string>
+#include <unistd.h>
+
+namespace OpMsgTest
+{
+
+struct Person
+{
+    std::string     name;
+    int             age;
+    bool operator==(Person const& rhs) const {return name == rhs.name && age == rhs.age;}
+};
+
+struct InsertReply
+{
+    double          ok;
+    int             n;
+};
+
+// Minimal unbuffered-write / small-buffer-read stream buffer over a file descriptor.
+// Used to talk to the stand-in server over a socketpair.
+class FdStreamBuf: public std::streambuf
+{
+    int     fd;
+    char    inBuffer[64];
+    public:
+        FdStreamBuf(int fd)
+            : fd(fd)
+        {
+            setg(inBuffer, inBuffer, inBuffer);
+        }
+    protected:
+        virtual int_type underflow() override
+        {
+            ssize_t size = ::read(fd, inBuffer, sizeof(inBuffer));
+            if (size <= 0)
+            {
+                return traits_type::eof();
+            }
+            setg(inBuffer, inBuffer, inBuffer + size);
+            return traits_type::to_int_type(*gptr());
+        }
+        virtual int_type overflow(int_type c) override
+        {
+            if (c == traits_type::eof())
+            {
+                return traits_type::not_eof(c);
+            }
+            char value = traits_type::to_char_type(c);
+            return xsputn(&value, 1) == 1 ? c : traits_type::eof();
+        }
+        virtual std::streamsize xsputn(char_type const* s, std::streamsize n) override
+        {
+            std::streamsize written = 0;
+            while (written < n)
+            {
+                ssize_t size = ::write(fd, s + written, n - written);
+                if (size <= 0)
+                {
+                    break;
+                }
+                written += size;
+            }
+            return written;
+        }
+};
+
+}
+
+ThorsAnvil_MakeTrait(OpMsgTest::Person, name, age);
+ThorsAnvil_MakeTrait(OpMsgTest::InsertReply, ok, n);
+
+#endif
@@ -0,0 +1,133 @@
+#include "SerializeConfig.h"
+#include "gtest/gtest.h"
+#include "JsonThor.h"
+#include "BsonThor.h"
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ThorsAnvil::Serialize;
+
+namespace OmitDefaultsTest
+{
+    struct Sparse
+    {
+        int                         count;
+        double                      ratio;
+        bool                        flag;
+        std::string                 name;
+        std::vector<int>            data;
+        std::unique_ptr<int>        ptr;
+        int*                        raw;
+    };
+    struct Child
+    {
+        int                         value;
+        std::string                 label;
+    };
+    struct Parent
+    {
+        std::string                 name;
+        Child                       child;
+        std::vector<Child>          children;
+    };
+    struct AlwaysAll
+    {
+        int                         value;
+        std::string                 label;
+    };
+    struct NeverAll
+    {
+        int                         value;
+        std::string                 label;
+    };
+}
+ThorsAnvil_MakeTrait(OmitDefaultsTest::Sparse, count, ratio, flag, name, data, ptr, raw);
+ThorsAnvil_MakeTrait(OmitDefaultsTest::Child, value, label);
+ThorsAnvil_MakeTrait(OmitDefaultsTest::Parent, name, child, children);
+ThorsAnvil_MakeTrait(OmitDefaultsTest::AlwaysAll, value, label);
+ThorsAnvil_MakeTrait(OmitDefaultsTest::NeverAll, value, label);
+ThorsAnvil_MakeOmitDefaults(OmitDefaultsTest::AlwaysAll, false);
+ThorsAnvil_MakeOmitDefaults(OmitDefaultsTest::NeverAll, true);
+
+using OmitDefaultsTest::Sparse;
+using OmitDefaultsTest::Parent;
+
+static PrinterInterface::PrinterConfig omitConfig()
+{
+    PrinterInterface::PrinterConfig     config(PrinterInterface::OutputType::Stream);
+    config.omitDefaults = true;
+    return config;
+}
+
+TEST(OmitDefaultsTest, DefaultValuesOmitted)
+{
+    Sparse              value{0, 0.0, false, "", {}, nullptr, nullptr};
+    std::stringstream   stream;
+    stream << jsonExporter(value, omitConfig());
+    EXPECT_EQ("{}", stream.str());
+}
+
+TEST(OmitDefaultsTest, NonDefaultValuesWritten)
+{
+    int                 target = 5;
+    Sparse              value{1, 0.5, true, "N", {1}, std::make_unique<int>(0), &target};
+    std::stringstream   stream;
+    stream << jsonExporter(value, omitConfig());
+    EXPECT_EQ(R"({"count":1,"ratio":0.5,"flag":true,"name":"N","data":[1],"ptr":0,"raw":5})", stream.str());
+}
+
+TEST(OmitDefaultsTest, OffByDefault)
+{
+    Sparse              value{0, 0.0, false, "", {}, nullptr, nullptr};
+    std::stringstream   stream;
+    stream << jsonExporter(value, PrinterInterface::OutputType::Stream);
+    EXPECT_EQ(R"({"count":0,"ratio":0.0,"flag":false,"name":"","data":[],"ptr":null,"raw":null})", stream.str());
+}
+
+TEST(OmitDefaultsTest, NestedObjectsAndArrayElements)
+{
+    Parent              value{"", {0, ""}, {{0, ""}, {1, "A"}}};
+    std::stringstream   stream;
+    stream << jsonExporter(value, omitConfig());
+    // Objects are always written (only their members are omitted). Array elements are always written.
+    EXPECT_EQ(R"({"child":{},"children":[{},{"value":1,"label":"A"}]})", stream.str());
+}
+
+TEST(OmitDefaultsTest, PerTypeOverride)
+{
+    std::stringstream   always;
+    always << jsonExporter(OmitDefaultsTest::AlwaysAll{0, ""}, omitConfig());
+    EXPECT_EQ(R"({"value":0,"label":""})", always.str());
+
+    std::stringstream   never;
+    never << jsonExporter(OmitDefaultsTest::NeverAll{0, ""}, PrinterInterface::OutputType::Stream);
+    EXPECT_EQ("{}", never.str());
+}
+
+TEST(OmitDefaultsTest, BsonSizeAgrees)
+{
+    Parent              value{"", {0, "L"}, {{0, ""}, {1, "A"}}};
+    std::stringstream   stream;
+    stream << bsonExporter(value, omitConfig());
+    std::string const   bson = stream.str();
+    // The leading int32 is the document size.
+    ASSERT_GE(bson.size(), 4);
+    std::int32_t        size = static_cast<unsigned char>(bson[0])
+                             | (static_cast<unsigned char>(bson[1]) << 8)
+                             | (static_cast<unsigned char>(bson[2]) << 16)
+                             | (static_cast<unsigned char>(bson[3]) << 24);
+    EXPECT_EQ(bson.size(), static_cast<std::size_t>(size));
+
+    Parent              result{"untouched", {7, "untouched"}, {}};
+    EXPECT_TRUE(stream >> bsonImporter(result));
+    EXPECT_EQ("untouched", result.name);
+    EXPECT_EQ(7, result.child.value);
+    EXPECT_EQ("L", result.child.label);
+    ASSERT_EQ(2, result.children.size());
+    EXPECT_EQ(1, result.children[1].value);
+
+    std::size_t         expected = exportSize<Bson>(value, omitConfig());
+    EXPECT_EQ(bson.size(), expected);
+}
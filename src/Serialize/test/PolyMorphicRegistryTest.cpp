@@ -0,0 +1,213 @@
+#include "SerializeConfig.h"
+#include "gtest/gtest.h"
+#include "Serialize.h"
+#include "Serialize.tpp"
+#include "Traits.h"
+#include "JsonThor.h"
+#include "BsonThor.h"
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace PolyMorphicRegistryTest
+{
+struct Shape
+{
+    virtual ~Shape() {}
+    int     colour  = 0;
+    ThorsAnvil_PolyMorphicSerializer(PolyMorphicRegistryTest::Shape);
+};
+struct Circle: public Shape
+{
+    int     radius  = 0;
+    ThorsAnvil_PolyMorphicSerializer(PolyMorphicRegistryTest::Circle);
+};
+struct Square: public Shape
+{
+    int     side    = 0;
+    ThorsAnvil_PolyMorphicSerializer(PolyMorphicRegistryTest::Square);
+};
+struct Drawing
+{
+    std::vector<std::unique_ptr<Shape>>     shapes;
+};
+
+inline std::vector<std::unique_ptr<Shape>> makeShapes(int count)
+{
+    std::vector<std::unique_ptr<Shape>> result;
+    for (int loop = 0; loop < count; ++loop)
+    {
+        if (loop % 2 == 0)
+        {
+            auto circle = std::make_unique<Circle>();
+            circle->colour  = loop;
+            circle->radius  = loop * 2;
+            result.emplace_back(std::move(circle));
+        }
+        else
+        {
+            auto square = std::make_unique<Square>();
+            square->colour  = loop;
+            square->side    = loop * 3;
+            result.emplace_back(std::move(square));
+        }
+    }
+    return result;
+}
+}
+
+ThorsAnvil_MakeTrait(PolyMorphicRegistryTest::Shape, colour);
+ThorsAnvil_ExpandTrait(PolyMorphicRegistryTest::Shape, PolyMorphicRegistryTest::Circle, radius);
+ThorsAnvil_ExpandTrait(PolyMorphicRegistryTest::Shape, PolyMorphicRegistryTest::Square, side);
+ThorsAnvil_MakeTrait(PolyMorphicRegistryTest::Drawing, shapes);
+
+using namespace ThorsAnvil::Serialize;
+using PolyMorphicRegistryTest::Shape;
+using PolyMorphicRegistryTest::Circle;
+using PolyMorphicRegistryTest::Square;
+using PolyMorphicRegistryTest::Drawing;
+
+static_assert(polyMorphicTypeId("PolyMorphicRegistryTest::Circle") >= 0, "Type id is computed at compile time");
+
+TEST(PolyMorphicRegistryTest, LookupByName)
+{
+    std::unique_ptr<Shape>  circle(PolyMorphicRegistry::getNamedTypeConvertedTo<Shape>("PolyMorphicRegistryTest::Circle"));
+    std::unique_ptr<Shape>  square(PolyMorphicRegistry::getNamedTypeConvertedTo<Shape>("PolyMorphicRegistryTest::Square"));
+
+    EXPECT_NE(nullptr, dynamic_cast<Circle*>(circle.get()));
+    EXPECT_NE(nullptr, dynamic_cast<Square*>(square.get()));
+    EXPECT_THROW(PolyMorphicRegistry::getNamedTypeConvertedTo<Shape>("PolyMorphicRegistryTest::Triangle"), std::runtime_error);
+}
+TEST(PolyMorphicRegistryTest, LookupById)
+{
+    std::unique_ptr<Shape>  circle(PolyMorphicRegistry::getTypeIdConvertedTo<Shape>(polyMorphicTypeId("PolyMorphicRegistryTest::Circle")));
+
+    EXPECT_NE(nullptr, dynamic_cast<Circle*>(circle.get()));
+    EXPECT_THROW(PolyMorphicRegistry::getTypeIdConvertedTo<Shape>(polyMorphicTypeId("PolyMorphicRegistryTest::Triangle")), std::runtime_error);
+}
+TEST(PolyMorphicRegistryTest, JsonTypeId)
+{
+    Drawing     drawing{PolyMorphicRegistryTest::makeShapes(2)};
+
+    PrinterInterface::PrinterConfig printConfig{PrinterInterface::OutputType::Stream};
+    printConfig.polymorphicTypeId = true;
+    std::stringstream   stream;
+    stream << jsonExporter(drawing, printConfig);
+
+    std::string const   expected = R"({"shapes":[{"__type":)" + std::to_string(polyMorphicTypeId("PolyMorphicRegistryTest::Circle")) + R"(,"radius":0,"colour":0},)"
+                                 + R"({"__type":)" + std::to_string(polyMorphicTypeId("PolyMorphicRegistryTest::Square")) + R"(,"side":3,"colour":1}]})";
+    EXPECT_EQ(expected, stream.str());
+
+    ParserInterface::ParserConfig   parseConfig;
+    parseConfig.polymorphicTypeId = true;
+    Drawing     result;
+    stream >> jsonImporter(result, parseConfig);
+    ASSERT_EQ(2, result.shapes.size());
+    ASSERT_NE(nullptr, dynamic_cast<Square*>(result.shapes[1].get()));
+    EXPECT_EQ(3, dynamic_cast<Square*>(result.shapes[1].get())->side);
+}
+TEST(PolyMorphicRegistryTest, BsonTypeIdIsSmaller)
+{
+    Drawing     drawing{PolyMorphicRegistryTest::makeShapes(10)};
+
+    std::stringstream   byName;
+    byName << bsonExporter(drawing);
+
+    PrinterInterface::PrinterConfig printConfig;
+    printConfig.polymorphicTypeId = true;
+    std::stringstream   byId;
+    byId << bsonExporter(drawing, printConfig);
+    EXPECT_EQ(byId.str().size(), bsonGetPrintSize(drawing, printConfig));
+    EXPECT_LT(byId.str().size(), byName.str().size());
+
+    ParserInterface::ParserConfig   parseConfig;
+    parseConfig.polymorphicTypeId = true;
+    Drawing     result;
+    byId >> bsonImporter(result, parseConfig);
+    ASSERT_EQ(10, result.shapes.size());
+    for (int loop = 0; loop < 10; ++loop)
+    {
+        EXPECT_EQ(loop, result.shapes[loop]->colour);
+        EXPECT_EQ(loop % 2 == 0, dynamic_cast<Circle*>(result.shapes[loop].get()) != nullptr);
+    }
+}
+TEST(PolyMorphicRegistryTest, ConcurrentLookup)
+{
+    std::vector<std::thread>    threads;
+    std::vector<int>            found(4, 0);
+    for (int thread = 0; thread < 4; ++thread)
+    {
+        threads.emplace_back([&found, thread]()
+        {
+            for (int loop = 0; loop < 1000; ++loop)
+            {
+                std::unique_ptr<Shape>  shape(PolyMorphicRegistry::getNamedTypeConvertedTo<Shape>(loop % 2 ? "PolyMorphicRegistryTest::Square" : "PolyMorphicRegistryTest::Circle"));
+                found[thread] += (dynamic_cast<Square*>(shape.get()) != nullptr);
+            }
+        });
+    }
+    for (auto& thread: threads)
+    {
+        thread.join();
+    }
+    for (int count: found)
+    {
+        EXPECT_EQ(500, count);
+    }
+}
+// Timing only: run with --gtest_also_run_disabled_tests (results are recorded as test properties).
+TEST(PolyMorphicRegistryTest, DISABLED_Benchmark)
+{
+    int const   count   = 20000;
+    Drawing     drawing{PolyMorphicRegistryTest::makeShapes(count)};
+
+    // Lookup cost: the registry against a std::map of std::function (the previous implementation).
+    std::map<std::string, std::function<void*()>>   mapRegistry;
+    for (char const* name: {"PolyMorphicRegistryTest::Shape", "PolyMorphicRegistryTest::Circle", "PolyMorphicRegistryTest::Square"})
+    {
+        mapRegistry[name] = [](){return static_cast<void*>(new Circle);};
+    }
+    std::vector<std::string> const  names{"PolyMorphicRegistryTest::Circle", "PolyMorphicRegistryTest::Square"};
+    auto timeLookup = [&](auto&& lookup)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (int loop = 0; loop < count; ++loop)
+        {
+            delete static_cast<Shape*>(lookup(names[loop % 2]));
+        }
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    };
+    // The previous getNamedTypeConvertedTo() took a copy of the map for each lookup.
+    auto copyTime   = timeLookup([&](std::string const& name){auto copy = mapRegistry;auto find = copy.find(name);return find->second();});
+    auto mapTime    = timeLookup([&](std::string const& name){auto find = mapRegistry.find(name);return find->second();});
+    auto hashTime   = timeLookup([](std::string const& name){return PolyMorphicRegistry::getNamedTypeConvertedTo<Shape>(name);});
+
+    // Bson round trip: class name against type id.
+    auto timeBson = [&](bool useId)
+    {
+        PrinterInterface::PrinterConfig printConfig;
+        ParserInterface::ParserConfig   parseConfig;
+        printConfig.polymorphicTypeId   = useId;
+        parseConfig.polymorphicTypeId   = useId;
+        std::stringstream   stream;
+        stream << bsonExporter(drawing, printConfig);
+
+        auto start = std::chrono::steady_clock::now();
+        Drawing     result;
+        stream >> bsonImporter(result, parseConfig);
+        EXPECT_EQ(count, result.shapes.size());
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    };
+    auto nameTime   = timeBson(false);
+    auto idTime     = timeBson(true);
+    ::testing::Test::RecordProperty("LookupMapCopyMicro", std::to_string(copyTime));
+    ::testing::Test::RecordProperty("LookupMapMicro", std::to_string(mapTime));
+    ::testing::Test::RecordProperty("LookupHashMicro", std::to_string(hashTime));
+    ::testing::Test::RecordProperty("BsonImportByNameMicro", std::to_string(nameTime));
+    ::testing::Test::RecordProperty("BsonImportByIdMicro", std::to_string(idTime));
+}
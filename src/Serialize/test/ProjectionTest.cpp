@@ -0,0 +1,195 @@
+#include "SerializeConfig.h"
+#include "gtest/gtest.h"
+#include "JsonThor.h"
+#include "BsonThor.h"
+#include "YamlThor.h"
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ThorsAnvil::Serialize;
+
+namespace ProjectionTest
+{
+    struct User
+    {
+        long                        id;
+        std::string                 name;
+    };
+    struct Entities
+    {
+        std::vector<std::string>    hashtags;
+        std::vector<std::string>    urls;
+    };
+    struct Tweet
+    {
+        std::string                 created_at;
+        std::string                 text;
+        User                        user;
+        Entities                    entities;
+    };
+}
+ThorsAnvil_MakeTrait(ProjectionTest::User, id, name);
+ThorsAnvil_MakeTrait(ProjectionTest::Entities, hashtags, urls);
+ThorsAnvil_MakeTrait(ProjectionTest::Tweet, created_at, text, user, entities);
+
+using ProjectionTest::Tweet;
+
+static Tweet const source{"Mon Oct 19", "Some long text", {42, "Loki"}, {{"cpp", "json"}, {"http://t.co"}}};
+static Tweet const marker{"untouched", "untouched", {-1, "untouched"}, {{}, {"untouched"}}};
+
+static void checkProjection(Tweet const& result)
+{
+    EXPECT_EQ("Mon Oct 19", result.created_at);
+    EXPECT_EQ("untouched", result.text);
+    EXPECT_EQ(42, result.user.id);
+    EXPECT_EQ("untouched", result.user.name);
+    EXPECT_EQ(source.entities.hashtags, result.entities.hashtags);
+    EXPECT_EQ(marker.entities.urls, result.entities.urls);
+}
+
+static ParserInterface::ParserConfig projection()
+{
+    ParserInterface::ParserConfig   config;
+    return config.withProjection({"user.id", "created_at", "entities.hashtags"});
+}
+
+TEST(ProjectionTest, JsonProjection)
+{
+    std::stringstream   stream;
+    stream << jsonExporter(source);
+
+    Tweet               result = marker;
+    EXPECT_TRUE(stream >> jsonImporter(result, projection()));
+    checkProjection(result);
+}
+
+TEST(ProjectionTest, BsonProjection)
+{
+    std::stringstream   stream;
+    stream << bsonExporter(source);
+
+    Tweet               result = marker;
+    EXPECT_TRUE(stream >> bsonImporter(result, projection()));
+    checkProjection(result);
+}
+
+TEST(ProjectionTest, YamlProjection)
+{
+    std::stringstream   stream;
+    stream << yamlExporter(source);
+
+    Tweet               result = marker;
+    ParserInterface::ParserConfig   config = projection();
+    config.catchExceptions = false;
+    // Note: The Yaml parser reads to the end of the stream (so the stream state is not checked).
+    stream >> yamlImporter(result, config);
+    checkProjection(result);
+}
+
+TEST(ProjectionTest, ProjectionThroughArray)
+{
+    std::vector<Tweet>  input{source, source};
+    std::stringstream   stream;
+    stream << jsonExporter(input);
+
+    std::vector<Tweet>  result;
+    ParserInterface::ParserConfig   config;
+    EXPECT_TRUE(stream >> jsonImporter(result, config.withProjection({"user.name"})));
+    ASSERT_EQ(2, result.size());
+    EXPECT_EQ("Loki", result[1].user.name);
+    EXPECT_EQ("", result[1].text);
+}
+
+TEST(ProjectionTest, SkippedMembersAllowedInStrictMode)
+{
+    std::stringstream   stream(R"({"created_at": "Mon Oct 19", "unknown": [1, 2], "user": {"id": 42, "name": "Loki"}})");
+
+    Tweet               result = marker;
+    ParserInterface::ParserConfig   config(ParserInterface::ParseType::Exact);
+    EXPECT_TRUE(stream >> jsonImporter(result, config.withProjection({"user", "created_at"})));
+    EXPECT_EQ("Mon Oct 19", result.created_at);
+    EXPECT_EQ(42, result.user.id);
+    EXPECT_EQ("Loki", result.user.name);
+    EXPECT_EQ("untouched", result.text);
+}
+
+TEST(ProjectionTest, LongerPathInsideSelectedMember)
+{
+    ParserInterface::ParserConfig   config;
+    config.withProjection({"user", "user.id"});
+    Projection const* user = config.projection->find("user");
+    ASSERT_NE(nullptr, user);
+    EXPECT_TRUE(user->selectsAll());
+    EXPECT_EQ(nullptr, config.projection->find("text"));
+}
+
+namespace ProjectionTest
+{
+    struct UserId
+    {
+        long                        id;
+    };
+    struct EntitiesTags
+    {
+        std::vector<std::string>    hashtags;
+    };
+    struct SmallTweet
+    {
+        std::string                 created_at;
+        UserId                      user;
+        EntitiesTags                entities;
+    };
+}
+ThorsAnvil_MakeTrait(ProjectionTest::UserId, id);
+ThorsAnvil_MakeTrait(ProjectionTest::EntitiesTags, hashtags);
+ThorsAnvil_MakeTrait(ProjectionTest::SmallTweet, created_at, user, entities);
+
+static PrinterInterface::PrinterConfig printProjection(PrinterInterface::OutputType type = PrinterInterface::OutputType::Default)
+{
+    PrinterInterface::PrinterConfig     config(type);
+    return config.withProjection({"user.id", "created_at", "entities.hashtags"});
+}
+static ProjectionTest::SmallTweet const smallSource{"Mon Oct 19", {42}, {{"cpp", "json"}}};
+
+TEST(ProjectionTest, JsonExportProjection)
+{
+    std::stringstream   projected;
+    std::stringstream   expected;
+    projected << jsonExporter(source, printProjection(PrinterInterface::OutputType::Stream));
+    expected  << jsonExporter(smallSource, PrinterInterface::OutputType::Stream);
+    EXPECT_EQ(expected.str(), projected.str());
+    EXPECT_EQ(R"({"created_at":"Mon Oct 19","user":{"id":42},"entities":{"hashtags":["cpp","json"]}})", projected.str());
+}
+
+TEST(ProjectionTest, BsonExportProjectionSizeAgrees)
+{
+    std::stringstream   projected;
+    std::stringstream   expected;
+    projected << bsonExporter(source, printProjection());
+    expected  << bsonExporter(smallSource);
+    EXPECT_EQ(expected.str(), projected.str());
+
+    Tweet               result = marker;
+    EXPECT_TRUE(projected >> bsonImporter(result));
+    checkProjection(result);
+}
+
+TEST(ProjectionTest, ExportProjectionThroughArray)
+{
+    std::vector<Tweet>  input{source, source};
+    std::stringstream   stream;
+    PrinterInterface::PrinterConfig     config(PrinterInterface::OutputType::Stream);
+    stream << jsonExporter(input, config.withProjection({"user.name"}));
+    EXPECT_EQ(R"([{"user":{"name":"Loki"}},{"user":{"name":"Loki"}}])", stream.str());
+}
+
+TEST(ProjectionTest, ExportWithoutProjectionUnchanged)
+{
+    std::stringstream   all;
+    std::stringstream   plain;
+    PrinterInterface::PrinterConfig     config(PrinterInterface::OutputType::Stream);
+    all   << jsonExporter(source, config.withProjection({"user", "text", "created_at", "entities"}));
+    plain << jsonExporter(source, PrinterInterface::OutputType::Stream);
+    EXPECT_EQ(plain.str(), all.str());
+}
@@ -6,6 +6,20 @@
 #include "test/SerializeTest.h"
 #include <algorithm>
 
+namespace EnumTableTest
+{
+    enum class ErrorCode {NotFound = 404, Ok = 0, Teapot = 418, ServerError = 500, Negative = -7, Alias = 0};
+    enum Instrument {I00, I01, I02, I03, I04, I05, I06, I07, I08, I09,
+                     I10, I11, I12, I13, I14, I15, I16, I17, I18, I19,
+                     I20, I21, I22, I23, I24, I25, I26, I27, I28, I29,
+                     I30, I31, I32, I33, I34, I35, I36, I37, I38, I39};
+}
+ThorsAnvil_MakeEnum(EnumTableTest::ErrorCode, NotFound, Ok, Teapot, ServerError, Negative, Alias);
+ThorsAnvil_MakeEnum(EnumTableTest::Instrument, I00, I01, I02, I03, I04, I05, I06, I07, I08, I09,
+                                               I10, I11, I12, I13, I14, I15, I16, I17, I18, I19,
+                                               I20, I21, I22, I23, I24, I25, I26, I27, I28, I29,
+                                               I30, I31, I32, I33, I34, I35, I36, I37, I38, I39);
+
 std::string stripspace(std::string const& value)
 {
     std::string  result(value);
@@ -230,6 +244,62 @@ TEST(SerializeEnumTest, EnumFlagOneThree)
     EXPECT_EQ("One | Three", str.str());
 }
 
+// The enum tables are built at compile time.
+using ErrorCodeTraits   = ThorsAnvil::Serialize::Traits<EnumTableTest::ErrorCode>;
+using InstrumentTraits  = ThorsAnvil::Serialize::Traits<EnumTableTest::Instrument>;
+static_assert(!ErrorCodeTraits::table.isDense(), "ErrorCode has gaps");
+static_assert(InstrumentTraits::table.isDense(), "Instrument has no gaps");
+static_assert(InstrumentTraits::table.getName(EnumTableTest::I27)[2] == '7', "Compile time enum => name");
+static_assert(ErrorCodeTraits::table.getName(static_cast<EnumTableTest::ErrorCode>(1)) == nullptr, "Compile time enum => name");
+static_assert([](){EnumTableTest::ErrorCode v{}; return ErrorCodeTraits::table.getValue("Teapot", 6, v) && v == EnumTableTest::ErrorCode::Teapot;}(), "Compile time name => enum");
 
+TEST(SerializeEnumTest, EnumTableSparseValues)
+{
+    EXPECT_STREQ("NotFound",    ErrorCodeTraits::getName(EnumTableTest::ErrorCode::NotFound));
+    EXPECT_STREQ("Teapot",      ErrorCodeTraits::getName(EnumTableTest::ErrorCode::Teapot));
+    EXPECT_STREQ("ServerError", ErrorCodeTraits::getName(EnumTableTest::ErrorCode::ServerError));
+    EXPECT_STREQ("Negative",    ErrorCodeTraits::getName(EnumTableTest::ErrorCode::Negative));
+    // Two names for the same value: The first one is used.
+    EXPECT_STREQ("Ok",          ErrorCodeTraits::getName(EnumTableTest::ErrorCode::Alias));
+    EXPECT_THROW(ErrorCodeTraits::getName(static_cast<EnumTableTest::ErrorCode>(42)), std::runtime_error);
+}
+TEST(SerializeEnumTest, EnumTableNameLookup)
+{
+    EXPECT_EQ(EnumTableTest::ErrorCode::NotFound,     ErrorCodeTraits::getValue("NotFound", ""));
+    EXPECT_EQ(EnumTableTest::ErrorCode::Negative,     ErrorCodeTraits::getValue("Negative", ""));
+    EXPECT_EQ(EnumTableTest::ErrorCode::Alias,        ErrorCodeTraits::getValue("Alias", ""));
+    EXPECT_THROW(ErrorCodeTraits::getValue("Teapo", ""),    std::runtime_error);
+    EXPECT_THROW(ErrorCodeTraits::getValue("Teapots", ""),  std::runtime_error);
+    EXPECT_THROW(ErrorCodeTraits::getValue("", ""),         std::runtime_error);
+}
+TEST(SerializeEnumTest, EnumTableAllValuesRoundTrip)
+{
+    for (std::size_t loop = 0; loop < InstrumentTraits::getSize(); ++loop)
+    {
+        EnumTableTest::Instrument   value = static_cast<EnumTableTest::Instrument>(loop);
+        std::string                 name  = InstrumentTraits::getName(value);
+        EXPECT_EQ(value, InstrumentTraits::getValue(name, ""));
+    }
+    EXPECT_EQ(40, InstrumentTraits::getValues().size());
+}
+TEST(SerializeEnumTest, JsonEnumTableSparse)
+{
+    std::vector<EnumTableTest::ErrorCode>   codes{EnumTableTest::ErrorCode::Teapot, EnumTableTest::ErrorCode::Ok, EnumTableTest::ErrorCode::Negative};
+    std::stringstream   str;
+    str << ThorsAnvil::Serialize::jsonExporter(codes, ThorsAnvil::Serialize::PrinterInterface::OutputType::Stream);
+    EXPECT_EQ(R"(["Teapot","Ok","Negative"])", str.str());
 
+    std::vector<EnumTableTest::ErrorCode>   result;
+    str >> ThorsAnvil::Serialize::jsonImporter(result);
+    EXPECT_EQ(codes, result);
+}
+TEST(SerializeEnumTest, BsonEnumTableDense)
+{
+    std::vector<EnumTableTest::Instrument>  instruments{EnumTableTest::I00, EnumTableTest::I39, EnumTableTest::I17};
+    std::stringstream   str;
+    str << ThorsAnvil::Serialize::bsonExporter(instruments);
 
+    std::vector<EnumTableTest::Instrument>  result;
+    str >> ThorsAnvil::Serialize::bsonImporter(result);
+    EXPECT_EQ(instruments, result);
+}
@@ -0,0 +1,117 @@
+#include "SerializeConfig.h"
+#include "gtest/gtest.h"
+#include "Transcoder.h"
+#include <vector>
+#include <sstream>
+
+using namespace ThorsAnvil::Serialize;
+
+namespace TranscoderTest
+{
+    struct Item
+    {
+        std::string         name;
+        int                 count;
+        long long           big;
+        double              price;
+        bool                valid;
+        std::vector<int>    tags;
+    };
+}
+ThorsAnvil_MakeTrait(TranscoderTest::Item, name, count, big, price, valid, tags);
+
+TEST(TranscoderTest, JsonToBsonMatchesExporter)
+{
+    TranscoderTest::Item    item{"Bolt", 12, 5'000'000'000LL, 1.25, true, {1, 2, 3}};
+    std::stringstream       json;
+    json << jsonExporter(item);
+
+    std::stringstream       bson;
+    EXPECT_TRUE((transcode<Json, Bson>(json, bson)));
+
+    std::stringstream       expected;
+    expected << bsonExporter(item);
+    EXPECT_EQ(expected.str(), bson.str());
+}
+
+TEST(TranscoderTest, BsonToJsonMatchesExporter)
+{
+    TranscoderTest::Item    item{"Nut", -3, -5'000'000'000LL, 0.5, false, {}};
+    std::stringstream       bson;
+    bson << bsonExporter(item);
+
+    std::stringstream       json;
+    EXPECT_TRUE((transcode<Bson, Json>(bson, json, ParserInterface::ParserConfig{}, PrinterInterface::OutputType::Stream)));
+
+    std::stringstream       expected;
+    expected << jsonExporter(item, PrinterInterface::OutputType::Stream);
+    EXPECT_EQ(expected.str(), json.str());
+}
+
+TEST(TranscoderTest, NestedRoundTrip)
+{
+    std::string             input = R"({"a":[1,[2,{"b":null}],"x"],"c":{"d":{"e":true}},"f":"é"})";
+    std::stringstream       json(input);
+    std::stringstream       bson;
+    EXPECT_TRUE((transcode<Json, Bson>(json, bson)));
+
+    std::stringstream       output;
+    EXPECT_TRUE((transcode<Bson, Json>(bson, output, ParserInterface::ParserConfig{}, PrinterInterface::OutputType::Stream)));
+    EXPECT_EQ(R"({"a":[1,[2,{"b":null}],"x"],"c":{"d":{"e":true}},"f":"é"})", output.str());
+}
+
+TEST(TranscoderTest, TopLevelArray)
+{
+    std::stringstream       json(R"([1, 2.5, "three"])");
+    std::stringstream       bson;
+    EXPECT_TRUE((transcode<Json, Bson>(json, bson)));
+
+    ParserInterface::ParserConfig   config;
+    config.parserInfo = static_cast<long>(BsonContainer::Array);
+    std::stringstream       output;
+    EXPECT_TRUE((transcode<Bson, Json>(bson, output, config, PrinterInterface::OutputType::Stream)));
+    EXPECT_EQ(R"([1,2.5,"three"])", output.str());
+}
+
+TEST(TranscoderTest, MultipleDocumentsOnOneStream)
+{
+    std::stringstream       json(R"({"a":1} {"b":2})");
+    std::stringstream       bson;
+    EXPECT_TRUE((transcode<Json, Bson>(json, bson)));
+    EXPECT_TRUE((transcode<Json, Bson>(json, bson)));
+
+    std::stringstream       output;
+    EXPECT_TRUE((transcode<Bson, Json>(bson, output, ParserInterface::ParserConfig{}, PrinterInterface::OutputType::Stream)));
+    EXPECT_TRUE((transcode<Bson, Json>(bson, output, ParserInterface::ParserConfig{}, PrinterInterface::OutputType::Stream)));
+    EXPECT_EQ(R"({"a":1}{"b":2})", output.str());
+}
+
+TEST(TranscoderTest, JsonToYaml)
+{
+    std::stringstream       json(R"({"name":"Bolt","count":12})");
+    std::stringstream       yaml;
+    EXPECT_TRUE((transcode<Json, Yaml>(json, yaml)));
+
+    std::stringstream       output;
+    EXPECT_TRUE((transcode<Yaml, Json>(yaml, output, ParserInterface::ParserConfig{}, PrinterInterface::OutputType::Stream)));
+    EXPECT_EQ(R"({"name":"Bolt","count":12})", output.str());
+}
+
+TEST(TranscoderTest, InvalidInputSetsFailBit)
+{
+    std::stringstream       json(R"({"a":[1,2})");
+    std::stringstream       bson;
+    EXPECT_FALSE((transcode<Json, Bson>(json, bson)));
+    EXPECT_FALSE(bson);
+    EXPECT_EQ("", bson.str());
+}
+
+TEST(TranscoderTest, InvalidInputThrows)
+{
+    std::stringstream       json(R"({"a":[1,2})");
+    std::stringstream       bson;
+    EXPECT_THROW(
+        (transcode<Json, Bson>(json, bson, ParserInterface::ParserConfig{false})),
+        std::runtime_error
+    );
+}
@@ -0,0 +1,136 @@
+#include "SerializeConfig.h"
+#include "gtest/gtest.h"
+#include "JsonThor.h"
+#include <chrono>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ThorsAnvil::Serialize;
+
+namespace TrustedInputTest
+{
+    struct User
+    {
+        long                                id;
+        std::string                         name;
+        std::string                         bio;
+        bool                                verified;
+    };
+    struct Status
+    {
+        std::string                         text;
+        User                                user;
+        std::vector<int>                    counts;
+        std::map<std::string, double>       scores;
+    };
+}
+ThorsAnvil_MakeTrait(TrustedInputTest::User, id, name, bio, verified);
+ThorsAnvil_MakeTrait(TrustedInputTest::Status, text, user, counts, scores);
+
+using TrustedInputTest::User;
+using TrustedInputTest::Status;
+
+static std::vector<Status> makeStatuses(int count)
+{
+    std::vector<Status> result;
+    for (int loop = 0; loop < count; ++loop)
+    {
+        result.push_back(Status{"Status text number " + std::to_string(loop) + " with \"quotes\"\tand a tab",
+                                User{loop * 1000L, "user" + std::to_string(loop), "Bio: \xC3\xA9t\xC3\xA9 \x01", loop % 2 == 0},
+                                {loop, -loop, 12345},
+                                {{"a", 1.5}, {"b/c", -2.25}}});
+    }
+    return result;
+}
+
+static ParserInterface::ParserConfig trusted()
+{
+    ParserInterface::ParserConfig   config;
+    config.trustedInput = true;
+    return config;
+}
+
+TEST(TrustedInputTest, SameResultAsValidatedParser)
+{
+    for (auto type: {PrinterInterface::OutputType::Default, PrinterInterface::OutputType::Stream})
+    {
+        std::vector<Status> statuses = makeStatuses(5);
+        std::stringstream   output;
+        output << jsonExporter(statuses, type);
+
+        std::vector<Status> validated;
+        std::vector<Status> fast;
+        std::stringstream   input1(output.str());
+        std::stringstream   input2(output.str());
+        ASSERT_TRUE(input1 >> jsonImporter(validated));
+        ASSERT_TRUE(input2 >> jsonImporter(fast, trusted()));
+
+        std::stringstream   check1;
+        std::stringstream   check2;
+        check1 << jsonExporter(validated, type);
+        check2 << jsonExporter(fast, type);
+        EXPECT_EQ(output.str(), check1.str());
+        EXPECT_EQ(output.str(), check2.str());
+        ASSERT_EQ(5, fast.size());
+        EXPECT_EQ(statuses[3].text, fast[3].text);
+        EXPECT_EQ(statuses[3].user.bio, fast[3].user.bio);
+    }
+}
+
+TEST(TrustedInputTest, TopLevelValuesAndEmptyContainers)
+{
+    int                 value = 0;
+    std::stringstream   input1("  42  ");
+    EXPECT_TRUE(input1 >> jsonImporter(value, trusted()));
+    EXPECT_EQ(42, value);
+
+    std::string         text;
+    std::stringstream   input2(R"("A é \\ \"B\"")");
+    EXPECT_TRUE(input2 >> jsonImporter(text, trusted()));
+    EXPECT_EQ("A \xC3\xA9 \\ \"B\"", text);
+
+    std::map<std::string, std::vector<int>> data;
+    std::stringstream   input3(R"({"a": [], "b": [1], "c": []})");
+    EXPECT_TRUE(input3 >> jsonImporter(data, trusted()));
+    EXPECT_EQ(3, data.size());
+    EXPECT_EQ(1, data["b"].size());
+}
+
+TEST(TrustedInputTest, IgnoresUnknownMembers)
+{
+    User                user;
+    std::stringstream   input(R"({"id": 1, "extra": {"x": [1, "}", {"y": null}]}, "name": "N", "bio": "", "verified": true})");
+    EXPECT_TRUE(input >> jsonImporter(user, trusted()));
+    EXPECT_EQ(1, user.id);
+    EXPECT_EQ("N", user.name);
+    EXPECT_TRUE(user.verified);
+}
+
+// Timing only: run with --gtest_also_run_disabled_tests (results are recorded as test properties).
+TEST(TrustedInputTest, DISABLED_Benchmark)
+{
+    std::vector<Status> statuses = makeStatuses(2000);
+    std::stringstream   output;
+    output << jsonExporter(statuses, PrinterInterface::OutputType::Stream);
+    std::string const   json = output.str();
+
+    auto time = [&](ParserInterface::ParserConfig config)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (int loop = 0; loop < 5; ++loop)
+        {
+            std::vector<Status> result;
+            std::stringstream   input(json);
+            input >> jsonImporter(result, config);
+            EXPECT_EQ(2000, result.size());
+        }
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    };
+    auto validated  = time(ParserInterface::ParserConfig{});
+    auto fast       = time(trusted());
+    ::testing::Test::RecordProperty("JsonImportBytes", std::to_string(json.size()));
+    ::testing::Test::RecordProperty("ValidatedImportX5Micro", std::to_string(validated));
+    ::testing::Test::RecordProperty("TrustedImportX5Micro", std::to_string(fast));
+}
@@ -0,0 +1,195 @@
+#include "SerializeConfig.h"
+#include "gtest/gtest.h"
+#include "JsonThor.h"
+#include "BsonThor.h"
+#include "CustomSerialization.h"
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace ThorsAnvil::Serialize;
+
+namespace TryImportTest
+{
+    struct Inner
+    {
+        int                 value;
+        std::string         name;
+    };
+    struct Outer
+    {
+        std::vector<Inner>  items;
+        double              total;
+    };
+    struct Percent
+    {
+        int                 value;
+    };
+    struct SerializePercent: public ThorsAnvil::Serialize::DefaultCustomSerializer<Percent>
+    {
+        virtual void writeJson(ThorsAnvil::Serialize::JsonPrinter& printer, Percent const& object) const override
+        {
+            printer.stream() << object.value;
+        }
+        virtual void readJson(ThorsAnvil::Serialize::JsonParser& parser, Percent& object) const override
+        {
+            parser.stream() >> object.value;
+            if (object.value < 0 || object.value > 100)
+            {
+                throw std::out_of_range("Percent out of range");
+            }
+        }
+    };
+    struct Rating
+    {
+        std::vector<Percent>    scores;
+    };
+}
+ThorsAnvil_MakeTrait(TryImportTest::Inner, value, name);
+ThorsAnvil_MakeTrait(TryImportTest::Outer, items, total);
+ThorsAnvil_MakeTraitCustomSerialize(TryImportTest::Percent, TryImportTest::SerializePercent);
+ThorsAnvil_MakeTrait(TryImportTest::Rating, scores);
+
+using TryImportTest::Inner;
+using TryImportTest::Outer;
+
+TEST(TryImportTest, ImportSuccess)
+{
+    Outer           outer;
+    ParseResult     result = tryJsonImport(std::string(R"({"items": [{"value": 1, "name": "One"}, {"value": 2, "name": "Two"}], "total": 3.5})"), outer);
+    ASSERT_TRUE(result);
+    EXPECT_TRUE(result.has_value());
+    ASSERT_EQ(2, outer.items.size());
+    EXPECT_EQ(2, outer.items[1].value);
+    EXPECT_EQ("Two", outer.items[1].name);
+    EXPECT_EQ(3.5, outer.total);
+}
+
+TEST(TryImportTest, ImportSyntaxError)
+{
+    Outer           outer;
+    ParseResult     result = tryJsonImport(std::string(R"({"items": [{"value": 1, "name": "One"}, {"value": 2 "name": "Two"}], "total": 3.5})"), outer);
+    ASSERT_FALSE(result);
+    EXPECT_EQ(ParseError::Syntax, result.error().code);
+    EXPECT_EQ(52, result.error().offset);
+}
+
+TEST(TryImportTest, ImportLexerError)
+{
+    Outer           outer;
+    ParseResult     result = tryJsonImport(std::string(R"({"items": [{"value": 1, "name": "One"}], "total": 3.x})"), outer);
+    ASSERT_FALSE(result);
+    EXPECT_EQ(ParseError::Syntax, result.error().code);
+    EXPECT_EQ("/total", result.error().path);
+}
+
+TEST(TryImportTest, ImportDataError)
+{
+    // Valid Json but "value" is not an integer.
+    Outer           outer;
+    ParseResult     result = tryJsonImport(std::string(R"({"items": [{"value": "one", "name": "One"}], "total": 3.5})"), outer);
+    ASSERT_FALSE(result);
+    EXPECT_EQ(ParseError::Data, result.error().code);
+    EXPECT_FALSE(result.error().message.empty());
+}
+
+TEST(TryImportTest, ImportFromStream)
+{
+    Outer               outer;
+    std::stringstream   good(R"({"items": [], "total": 1})");
+    EXPECT_TRUE(tryJsonImport(good, outer));
+    EXPECT_EQ(1, outer.total);
+
+    std::stringstream   bad(R"({"items": [, "total": 1})");
+    ParseResult         result = tryJsonImport(bad, outer);
+    EXPECT_FALSE(result);
+    EXPECT_EQ(ParseError::Syntax, result.error().code);
+    EXPECT_EQ(11, result.error().offset);
+    EXPECT_TRUE(bad.fail());
+
+    // The same input gives the same error from a buffer.
+    std::string         badBuffer(R"({"items": [, "total": 1})");
+    ParseResult         bufferResult = tryJsonImport(badBuffer, outer);
+    EXPECT_EQ(ParseError::Syntax, bufferResult.error().code);
+    EXPECT_EQ(11, bufferResult.error().offset);
+}
+
+TEST(TryImportTest, ImportDoesNotThrowWhenCatchExceptionsIsFalse)
+{
+    Outer                           outer;
+    ParserInterface::ParserConfig   config;
+    config.catchExceptions = false;
+    std::stringstream               bad(R"({"items": [{"value": true}]})");
+    EXPECT_NO_THROW(EXPECT_FALSE(tryJsonImport(bad, outer, config)));
+}
+
+TEST(TryImportTest, ErrorPathToFailingValue)
+{
+    Outer           outer;
+    std::string     input = R"({"items": [{"value": 1, "name": "One"}, {"value": 2, "name": "Two"}, {"value": "three"}], "total": 3.5})";
+    ParseResult     result = tryJsonImport(input, outer);
+    ASSERT_FALSE(result);
+    EXPECT_EQ(ParseError::Data, result.error().code);
+    EXPECT_EQ("/items/2/value", result.error().path);
+    EXPECT_NE(ParseError::unknown, result.error().offset);
+    // The lexer has just read the bad value.
+    EXPECT_GE(result.error().offset, input.find("\"three\""));
+    EXPECT_LE(result.error().offset, input.find("\"three\"") + 7);
+}
+
+TEST(TryImportTest, ErrorPathEscapesKeys)
+{
+    std::map<std::string, std::vector<int>> data;
+    std::stringstream   input(R"({"a/b~c": [1, 2, true]})");
+    ParseResult         result = tryJsonImport(input, data);
+    ASSERT_FALSE(result);
+    EXPECT_EQ("/a~1b~0c/2", result.error().path);
+    // The stream position is known but line/column are only set for in memory input.
+    EXPECT_NE(ParseError::unknown, result.error().offset);
+    EXPECT_EQ(0, result.error().line);
+}
+
+TEST(TryImportTest, ErrorLineAndColumn)
+{
+    Outer           outer;
+    std::string     input = "{\n"
+                            "    \"items\": [\n"
+                            "        {\"value\": 1, \"name\": \"One\"}\n"
+                            "    ],\n"
+                            "    \"total\": true\n"
+                            "}\n";
+    ParseResult     result = tryJsonImport(input, outer);
+    ASSERT_FALSE(result);
+    EXPECT_EQ("/total", result.error().path);
+    EXPECT_EQ(5, result.error().line);
+
+    std::string     syntax = "{\n"
+                             "    \"items\": [}\n"
+                             "}\n";
+    result = tryJsonImport(syntax, outer);
+    ASSERT_FALSE(result);
+    EXPECT_EQ(ParseError::Syntax, result.error().code);
+    EXPECT_EQ(16, result.error().offset);
+    EXPECT_EQ(2, result.error().line);
+    EXPECT_EQ(15, result.error().column);
+}
+
+TEST(TryImportTest, ImporterKeepsExceptionType)
+{
+    // The exception thrown by a custom serializer reaches the caller unchanged
+    // (the path and offset are logged and returned by tryJsonImport()).
+    TryImportTest::Rating           rating;
+    ParserInterface::ParserConfig   config;
+    config.catchExceptions = false;
+    std::stringstream               bad(R"({"scores": [10, 200]})");
+    EXPECT_THROW(bad >> jsonImporter(rating, config), std::out_of_range);
+
+    std::stringstream               again(R"({"scores": [10, 200]})");
+    ParseResult result = tryJsonImport(again, rating);
+    ASSERT_FALSE(result);
+    EXPECT_EQ(ParseError::Data, result.error().code);
+    EXPECT_EQ("/scores/1", result.error().path);
+    EXPECT_EQ("Percent out of range", result.error().message);
+}
@@ -19,3 +19,12 @@ TEST(TwitterTest, ReadTwitterObject)
     EXPECT_EQ(value.statuses[0].user.screen_name, "ayuu0123");
 }
 
+
+TEST(TwitterTest, ReadTwitterObjectMapped)
+{
+    using ThorsAnvil::Serialize::ParserInterface;
+    TwitterTest::Twitter    value;
+
+    EXPECT_TRUE(ThorsAnvil::Serialize::jsonImportFile("test/data/twitter.json", value, ParserInterface::ParseType::Weak));
+    EXPECT_EQ(value.statuses[0].user.screen_name, "ayuu0123");
+}